@@ -0,0 +1,126 @@
+#include "audio_data_registry.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+
+#include "audio_player_error.h"
+#include "log.h"
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+namespace {
+
+// FNV-1a over 8-byte words, which is several times faster than the
+// byte-wise variant for large buffers.
+uint64_t HashBytes(const uint8_t *data, size_t size) {
+  uint64_t hash = FNV_OFFSET_BASIS ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    hash = (hash ^ word) * FNV_PRIME;
+  }
+  for (; i < size; i++) {
+    hash = (hash ^ data[i]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+}  // namespace
+
+AudioData::AudioData(std::vector<uint8_t> &&bytes, uint64_t hash)
+    : bytes_(std::move(bytes)), hash_(hash) {
+  data_ = bytes_.data();
+  size_ = bytes_.size();
+}
+
+AudioData::AudioData(void *mapping, size_t size)
+    : mapping_(mapping),
+      data_(static_cast<const uint8_t *>(mapping)),
+      size_(size) {}
+
+AudioData::~AudioData() {
+  if (mapping_) {
+    munmap(mapping_, size_);
+  }
+}
+
+std::shared_ptr<const AudioData> AudioDataRegistry::Intern(
+    const uint8_t *data, size_t size) {
+  uint64_t hash = HashBytes(data, size);
+  auto range = buffers_.equal_range(hash);
+  for (auto iter = range.first; iter != range.second; ++iter) {
+    std::shared_ptr<const AudioData> buffer = iter->second.lock();
+    // Compares the content only on a hash match, to rule out collisions.
+    if (buffer && buffer->GetSize() == size &&
+        memcmp(buffer->GetData(), data, size) == 0) {
+      LOG_DEBUG("reuse audio data, size : %zu", size);
+      return buffer;
+    }
+  }
+
+  RemoveExpired();
+  auto buffer = std::make_shared<const AudioData>(
+      std::vector<uint8_t>(data, data + size), hash);
+  buffers_.emplace(hash, buffer);
+  return buffer;
+}
+
+std::shared_ptr<const AudioData> AudioDataRegistry::MapFile(
+    const std::string &path) {
+  std::string file_path = path;
+  if (file_path.rfind("file://", 0) == 0) {
+    file_path = file_path.substr(7);
+  }
+
+  int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw AudioPlayerError(strerror(errno), "Failed to open " + path);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    throw AudioPlayerError("Invalid file", path + " is empty or unreadable");
+  }
+  size_t size = static_cast<size_t>(file_stat.st_size);
+  int64_t modified_time_ns =
+      static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 +
+      file_stat.st_mtim.tv_nsec;
+
+  auto iter = files_.find(file_path);
+  if (iter != files_.end() && iter->second.size == size &&
+      iter->second.modified_time_ns == modified_time_ns) {
+    if (std::shared_ptr<const AudioData> data = iter->second.data.lock()) {
+      close(fd);
+      return data;
+    }
+  }
+
+  void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    throw AudioPlayerError(strerror(errno), "Failed to map " + path);
+  }
+
+  RemoveExpired();
+  auto data = std::make_shared<const AudioData>(mapping, size);
+  files_[file_path] = {data, modified_time_ns, size};
+  return data;
+}
+
+void AudioDataRegistry::RemoveExpired() {
+  for (auto iter = buffers_.begin(); iter != buffers_.end();) {
+    iter = iter->second.expired() ? buffers_.erase(iter) : std::next(iter);
+  }
+  for (auto iter = files_.begin(); iter != files_.end();) {
+    iter = iter->second.data.expired() ? files_.erase(iter) : std::next(iter);
+  }
+}
@@ -0,0 +1,70 @@
+#ifndef AUDIO_DATA_REGISTRY_H_
+#define AUDIO_DATA_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// An immutable block of encoded audio data, either owned bytes or a read-only
+// memory map of a file.
+class AudioData {
+ public:
+  AudioData(std::vector<uint8_t> &&bytes, uint64_t hash);
+  // Takes the ownership of |mapping|, which is unmapped on destruction.
+  AudioData(void *mapping, size_t size);
+  ~AudioData();
+
+  AudioData(const AudioData &) = delete;
+  AudioData &operator=(const AudioData &) = delete;
+
+  const uint8_t *GetData() const { return data_; }
+  size_t GetSize() const { return size_; }
+  uint64_t GetHash() const { return hash_; }
+
+ private:
+  std::vector<uint8_t> bytes_;
+  void *mapping_ = nullptr;
+  const uint8_t *data_;
+  size_t size_;
+  uint64_t hash_ = 0;
+};
+
+// Shares the audio data of the players and the sound pool, so that the same
+// content is held in memory only once. The registry only holds weak
+// references: a buffer is freed when its last user releases it.
+//
+// This class is not thread-safe.
+class AudioDataRegistry {
+ public:
+  AudioDataRegistry() = default;
+  ~AudioDataRegistry() = default;
+
+  // Returns the buffer with the same content as the |size| bytes at |data|,
+  // or a new buffer with a copy of them if there is none. The bytes are only
+  // copied if there is no such buffer.
+  std::shared_ptr<const AudioData> Intern(const uint8_t *data, size_t size);
+
+  // Returns a read-only memory map of the local file at |path|, which may
+  // start with "file://". The map is shared until the file is modified.
+  // Throws AudioPlayerError on failure.
+  std::shared_ptr<const AudioData> MapFile(const std::string &path);
+
+ private:
+  struct MappedFile {
+    std::weak_ptr<const AudioData> data;
+    // In nanoseconds, so that a file rewritten within a second is detected.
+    int64_t modified_time_ns;
+    size_t size;
+  };
+
+  void RemoveExpired();
+
+  std::unordered_multimap<uint64_t, std::weak_ptr<const AudioData>> buffers_;
+  std::map<std::string, MappedFile> files_;
+};
+
+#endif  // AUDIO_DATA_REGISTRY_H_
@@ -3,6 +3,8 @@
 #include "audio_player_error.h"
 #include "log.h"
 
+#define DEFAULT_POSITION_UPDATE_INTERVAL_MS 200
+
 AudioPlayer::AudioPlayer(const std::string &player_id, bool low_latency,
                          PreparedListener prepared_listener,
                          StartPlayingListener start_playing_listener,
@@ -22,6 +24,7 @@ AudioPlayer::AudioPlayer(const std::string &player_id, bool low_latency,
   playback_rate_ = 1.0;
   release_mode_ = RELEASE;
   should_seek_to_ = -1;
+  position_update_interval_ms_ = DEFAULT_POSITION_UPDATE_INTERVAL_MS;
 }
 
 AudioPlayer::~AudioPlayer() {
@@ -46,10 +49,11 @@ void AudioPlayer::Play() {
   switch (state) {
     case PLAYER_STATE_NONE:
     case PLAYER_STATE_IDLE:
-      if (audio_data_.size() > 0) {
-        LOG_DEBUG("set audio buffer, buffer size : %d", audio_data_.size());
-        result = player_set_memory_buffer(player_, (void *)audio_data_.data(),
-                                          audio_data_.size());
+      if (audio_data_) {
+        LOG_DEBUG("set audio buffer, buffer size : %zu",
+                  audio_data_->GetSize());
+        result = player_set_memory_buffer(
+            player_, audio_data_->GetData(), audio_data_->GetSize());
         HandleResult("player_set_memory_buffer", result);
       } else {
         LOG_DEBUG("set uri (%s)", url_.c_str());
@@ -135,7 +139,8 @@ void AudioPlayer::Seek(int position) {
 
 void AudioPlayer::SetUrl(const std::string &url) {
   LOG_INFO("AudioPlayer %s is setting url...", player_id_.c_str());
-  if (url != url_) {
+  // The player may be reading |audio_data_| even if |url| has not changed.
+  if (url != url_ || audio_data_) {
     url_ = url;
     ResetPlayer();
 
@@ -145,18 +150,20 @@ void AudioPlayer::SetUrl(const std::string &url) {
 
     PreparePlayer();
   }
-  audio_data_.clear();
+  audio_data_ = nullptr;
 }
 
-void AudioPlayer::SetDataSource(std::vector<uint8_t> &data) {
+void AudioPlayer::SetDataSource(std::shared_ptr<const AudioData> data) {
   LOG_INFO("AudioPlayer %s is setting buffer...", player_id_.c_str());
-  if (data != audio_data_) {
-    audio_data_.swap(data);
+  if (data && data != audio_data_) {
+    // The player may still read the previous buffer until it is reset.
+    std::shared_ptr<const AudioData> previous = std::move(audio_data_);
+    audio_data_ = std::move(data);
     ResetPlayer();
 
-    LOG_DEBUG("set audio buffer, buffer size : %d", audio_data_.size());
-    int result = player_set_memory_buffer(player_, (void *)audio_data_.data(),
-                                          audio_data_.size());
+    LOG_DEBUG("set audio buffer, buffer size : %zu", audio_data_->GetSize());
+    int result = player_set_memory_buffer(player_, audio_data_->GetData(),
+                                          audio_data_->GetSize());
     HandleResult("player_set_memory_buffer", result);
 
     PreparePlayer();
@@ -4,9 +4,11 @@
 #include <player.h>
 
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "audio_data_registry.h"
 #include "audio_player_options.h"
 
 using PreparedListener =
@@ -36,7 +38,9 @@ class AudioPlayer {
   // If you use HTTP or RTSP, URI must start with "http://" or "rtsp://".
   // The default protocol is "file://".
   void SetUrl(const std::string &url);
-  void SetDataSource(std::vector<uint8_t> &data);
+  // Plays |data| from memory. Setting the buffer that is already set, e.g.
+  // one returned by AudioDataRegistry for the same bytes, does nothing.
+  void SetDataSource(std::shared_ptr<const AudioData> data);
   void SetVolume(double volume);
   void SetPlaybackRate(double rate);
   void SetReleaseMode(ReleaseMode mode);
@@ -45,6 +49,19 @@ class AudioPlayer {
   std::string GetPlayerId() const;
   bool IsPlaying();
 
+  // The interval of position updates while playing. 0 disables them.
+  void SetPositionUpdateInterval(int interval_ms) {
+    position_update_interval_ms_ = interval_ms;
+  }
+  int GetPositionUpdateInterval() const { return position_update_interval_ms_; }
+  // The ecore_time_get() time of the last position update.
+  void SetLastPositionUpdateTime(double time) {
+    last_position_update_time_ = time;
+  }
+  double GetLastPositionUpdateTime() const {
+    return last_position_update_time_;
+  }
+
  private:
   // the player state should be none before call this function
   void CreatePlayer();
@@ -64,7 +81,7 @@ class AudioPlayer {
   std::string player_id_;
   bool low_latency_;
   std::string url_;
-  std::vector<uint8_t> audio_data_;
+  std::shared_ptr<const AudioData> audio_data_;
   double volume_;
   double playback_rate_;
   ReleaseMode release_mode_;
@@ -72,6 +89,8 @@ class AudioPlayer {
   bool preparing_ = false;
   bool seeking_ = false;
   bool should_play_ = false;
+  int position_update_interval_ms_;
+  double last_position_update_time_ = 0;
   PreparedListener prepared_listener_;
   StartPlayingListener start_playing_listener_;
   SeekCompletedListener seek_completed_listener_;
@@ -6,14 +6,30 @@
 #include <flutter/plugin_registrar.h>
 #include <flutter/standard_method_codec.h>
 
+#include <algorithm>
 #include <map>
 
+#include "audio_data_registry.h"
 #include "audio_player.h"
 #include "audio_player_error.h"
 #include "audio_player_options.h"
 #include "log.h"
+#include "sound_pool.h"
 
-#define TIMEOUT 0.2
+// The timer interval while no playing player wants position updates yet.
+#define DEFAULT_TIMER_INTERVAL_MS 200
+
+namespace {
+
+// Returns the value of |key| in |map|, or a null value if there is none.
+const flutter::EncodableValue &GetValue(const flutter::EncodableMap &map,
+                                        const char *key) {
+  static const flutter::EncodableValue null_value;
+  auto iter = map.find(flutter::EncodableValue(key));
+  return iter != map.end() ? iter->second : null_value;
+}
+
+}  // namespace
 
 class AudioplayersTizenPlugin : public flutter::Plugin {
  public:
@@ -34,6 +50,8 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
 
     channel_ = std::move(channel);
     timer_ = nullptr;
+    timer_interval_ms_ = DEFAULT_TIMER_INTERVAL_MS;
+    batch_position_updates_ = false;
   }
 
   virtual ~AudioplayersTizenPlugin() {
@@ -49,10 +67,31 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
     LOG_DEBUG("HandleMethodCall: %s", method_call.method_name().c_str());
     const flutter::EncodableValue *args = method_call.arguments();
-    if (std::holds_alternative<flutter::EncodableMap>(*args)) {
-      flutter::EncodableMap encodables = std::get<flutter::EncodableMap>(*args);
-      flutter::EncodableValue &player_id_value =
-          encodables[flutter::EncodableValue("playerId")];
+    if (method_call.method_name().compare("setPositionUpdateBatching") == 0) {
+      // Not bound to a player.
+      const auto *encodables = std::get_if<flutter::EncodableMap>(args);
+      if (encodables) {
+        auto iter = encodables->find(flutter::EncodableValue("enabled"));
+        if (iter != encodables->end() &&
+            std::holds_alternative<bool>(iter->second)) {
+          batch_position_updates_ = std::get<bool>(iter->second);
+          result->Success(flutter::EncodableValue(1));
+          return;
+        }
+      }
+      result->Error("Invalid arguments",
+                    "setPositionUpdateBatching requires enabled");
+      return;
+    }
+    if (method_call.method_name().rfind("soundPool.", 0) == 0) {
+      HandleSoundPoolCall(method_call, std::move(result));
+      return;
+    }
+    // Read in place: the arguments of playBytes hold the whole clip.
+    if (const auto *map = std::get_if<flutter::EncodableMap>(args)) {
+      const flutter::EncodableMap &encodables = *map;
+      const flutter::EncodableValue &player_id_value =
+          GetValue(encodables, "playerId");
       std::string player_id;
       if (std::holds_alternative<std::string>(player_id_value)) {
         player_id = std::get<std::string>(player_id_value);
@@ -63,8 +102,7 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
         return;
       }
 
-      flutter::EncodableValue &mode_value =
-          encodables[flutter::EncodableValue("mode")];
+      const flutter::EncodableValue &mode_value = GetValue(encodables, "mode");
       std::string mode;
       if (std::holds_alternative<std::string>(mode_value)) {
         mode = std::get<std::string>(mode_value);
@@ -74,36 +112,36 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
       AudioPlayer *player = GetAudioPlayer(player_id, mode);
       try {
         if (method_call.method_name().compare("play") == 0) {
-          flutter::EncodableValue &volume =
-              encodables[flutter::EncodableValue("volume")];
+          const flutter::EncodableValue &volume =
+              GetValue(encodables, "volume");
           if (std::holds_alternative<double>(volume)) {
             player->SetVolume(std::get<double>(volume));
           }
-          flutter::EncodableValue &url =
-              encodables[flutter::EncodableValue("url")];
+          const flutter::EncodableValue &url = GetValue(encodables, "url");
           if (std::holds_alternative<std::string>(url)) {
             player->SetUrl(std::get<std::string>(url));
           }
           player->Play();
-          flutter::EncodableValue &position =
-              encodables[flutter::EncodableValue("position")];
+          const flutter::EncodableValue &position =
+              GetValue(encodables, "position");
           if (std::holds_alternative<int32_t>(position)) {
             player->Seek(std::get<int32_t>(position));
           }
         } else if (method_call.method_name().compare("playBytes") == 0) {
-          flutter::EncodableValue &volume =
-              encodables[flutter::EncodableValue("volume")];
+          const flutter::EncodableValue &volume =
+              GetValue(encodables, "volume");
           if (std::holds_alternative<double>(volume)) {
             player->SetVolume(std::get<double>(volume));
           }
-          flutter::EncodableValue &bytes =
-              encodables[flutter::EncodableValue("bytes")];
+          const flutter::EncodableValue &bytes = GetValue(encodables, "bytes");
           if (std::holds_alternative<std::vector<uint8_t>>(bytes)) {
-            player->SetDataSource(std::get<std::vector<uint8_t>>(bytes));
+            const auto &data = std::get<std::vector<uint8_t>>(bytes);
+            player->SetDataSource(
+                audio_data_registry_.Intern(data.data(), data.size()));
           }
           player->Play();
-          flutter::EncodableValue &position =
-              encodables[flutter::EncodableValue("position")];
+          const flutter::EncodableValue &position =
+              GetValue(encodables, "position");
           if (std::holds_alternative<int32_t>(position)) {
             player->Seek(std::get<int32_t>(position));
           }
@@ -116,8 +154,8 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
         } else if (method_call.method_name().compare("release") == 0) {
           player->Release();
         } else if (method_call.method_name().compare("seek") == 0) {
-          flutter::EncodableValue &position =
-              encodables[flutter::EncodableValue("position")];
+          const flutter::EncodableValue &position =
+              GetValue(encodables, "position");
           if (std::holds_alternative<int32_t>(position)) {
             player->Seek(std::get<int32_t>(position));
           } else {
@@ -125,8 +163,8 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
                           "seek failed because of invalid position");
           }
         } else if (method_call.method_name().compare("setVolume") == 0) {
-          flutter::EncodableValue &volume =
-              encodables[flutter::EncodableValue("volume")];
+          const flutter::EncodableValue &volume =
+              GetValue(encodables, "volume");
           if (std::holds_alternative<double>(volume)) {
             player->SetVolume(std::get<double>(volume));
           } else {
@@ -134,8 +172,7 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
                           "setVolume failed because of invalid volume");
           }
         } else if (method_call.method_name().compare("setUrl") == 0) {
-          flutter::EncodableValue &url =
-              encodables[flutter::EncodableValue("url")];
+          const flutter::EncodableValue &url = GetValue(encodables, "url");
           if (std::holds_alternative<std::string>(url)) {
             player->SetUrl(std::get<std::string>(url));
           } else {
@@ -143,8 +180,8 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
                           "SetUrl failed because of invalid url");
           }
         } else if (method_call.method_name().compare("setPlaybackRate") == 0) {
-          flutter::EncodableValue &rate =
-              encodables[flutter::EncodableValue("playbackRate")];
+          const flutter::EncodableValue &rate =
+              GetValue(encodables, "playbackRate");
           if (std::holds_alternative<double>(rate)) {
             player->SetPlaybackRate(std::get<double>(rate));
           } else {
@@ -152,8 +189,8 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
                           "setPlaybackRate failed because of invalid rate");
           }
         } else if (method_call.method_name().compare("setReleaseMode") == 0) {
-          flutter::EncodableValue &release_mode_value =
-              encodables[flutter::EncodableValue("releaseMode")];
+          const flutter::EncodableValue &release_mode_value =
+              GetValue(encodables, "releaseMode");
           if (std::holds_alternative<std::string>(release_mode_value)) {
             std::string release_mode =
                 std::get<std::string>(release_mode_value);
@@ -169,6 +206,21 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
                 "Invalid ReleaseMode",
                 "setReleaseMode failed because of invalid ReleaseMode");
           }
+        } else if (method_call.method_name().compare(
+                       "setPositionUpdateInterval") == 0) {
+          const flutter::EncodableValue &interval =
+              GetValue(encodables, "interval");
+          if (std::holds_alternative<int32_t>(interval)) {
+            player->SetPositionUpdateInterval(
+                std::max(std::get<int32_t>(interval), 0));
+            if (player->IsPlaying()) {
+              StartPositionUpdates(this);
+            }
+          } else {
+            result->Error(
+                "Invalid interval",
+                "setPositionUpdateInterval failed because of invalid interval");
+          }
         } else if (method_call.method_name().compare("getDuration") == 0) {
           int duration = player->GetDuration();
           result->Success(flutter::EncodableValue(duration));
@@ -192,6 +244,80 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
     }
   }
 
+  void HandleSoundPoolCall(
+      const flutter::MethodCall<flutter::EncodableValue> &method_call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    const std::string &method_name = method_call.method_name();
+    static const flutter::EncodableMap empty_map;
+    const auto *args =
+        std::get_if<flutter::EncodableMap>(method_call.arguments());
+    const flutter::EncodableMap &encodables = args ? *args : empty_map;
+    try {
+      if (method_name.compare("soundPool.release") == 0) {
+        sound_pool_.reset();
+        result->Success(flutter::EncodableValue(1));
+        return;
+      }
+      if (!sound_pool_) {
+        sound_pool_ = std::make_unique<SoundPool>();
+      }
+      if (method_name.compare("soundPool.load") == 0) {
+        const flutter::EncodableValue &url = GetValue(encodables, "url");
+        const flutter::EncodableValue &bytes = GetValue(encodables, "bytes");
+        int sound_id;
+        if (std::holds_alternative<std::string>(url)) {
+          // The file is only read while decoding, so it is mapped rather
+          // than copied.
+          std::shared_ptr<const AudioData> data =
+              audio_data_registry_.MapFile(std::get<std::string>(url));
+          sound_id = sound_pool_->Load(data->GetData(), data->GetSize());
+        } else if (std::holds_alternative<std::vector<uint8_t>>(bytes)) {
+          const auto &data = std::get<std::vector<uint8_t>>(bytes);
+          sound_id = sound_pool_->Load(data.data(), data.size());
+        } else {
+          result->Error("Invalid arguments",
+                        "soundPool.load requires url or bytes");
+          return;
+        }
+        result->Success(flutter::EncodableValue(sound_id));
+      } else if (method_name.compare("soundPool.play") == 0) {
+        const flutter::EncodableValue &sound_id =
+            GetValue(encodables, "soundId");
+        const flutter::EncodableValue &volume = GetValue(encodables, "volume");
+        const flutter::EncodableValue &loop = GetValue(encodables, "loop");
+        if (!std::holds_alternative<int32_t>(sound_id)) {
+          result->Error("Invalid arguments",
+                        "soundPool.play requires soundId");
+          return;
+        }
+        int voice_id = sound_pool_->Play(
+            std::get<int32_t>(sound_id),
+            std::holds_alternative<double>(volume) ? std::get<double>(volume)
+                                                   : 1.0,
+            std::holds_alternative<bool>(loop) && std::get<bool>(loop));
+        result->Success(flutter::EncodableValue(voice_id));
+      } else if (method_name.compare("soundPool.stop") == 0) {
+        const flutter::EncodableValue &voice_id =
+            GetValue(encodables, "voiceId");
+        if (std::holds_alternative<int32_t>(voice_id)) {
+          sound_pool_->Stop(std::get<int32_t>(voice_id));
+        }
+        result->Success(flutter::EncodableValue(1));
+      } else if (method_name.compare("soundPool.unload") == 0) {
+        const flutter::EncodableValue &sound_id =
+            GetValue(encodables, "soundId");
+        if (std::holds_alternative<int32_t>(sound_id)) {
+          sound_pool_->Unload(std::get<int32_t>(sound_id));
+        }
+        result->Success(flutter::EncodableValue(1));
+      } else {
+        result->NotImplemented();
+      }
+    } catch (const AudioPlayerError &e) {
+      result->Error(e.GetCode(), e.GetMessage());
+    }
+  }
+
   AudioPlayer *GetAudioPlayer(const std::string &player_id,
                               const std::string &mode) {
     auto iter = audio_players_.find(player_id);
@@ -261,61 +387,96 @@ class AudioplayersTizenPlugin : public flutter::Plugin {
 
   static void StartPositionUpdates(void *data) {
     AudioplayersTizenPlugin *plugin = (AudioplayersTizenPlugin *)data;
+    if (plugin->timer_ &&
+        plugin->timer_interval_ms_ > DEFAULT_TIMER_INTERVAL_MS) {
+      // Don't let a slow running timer delay the new player's first update.
+      // The next tick adjusts the interval again.
+      plugin->timer_interval_ms_ = DEFAULT_TIMER_INTERVAL_MS;
+      ecore_timer_interval_set(plugin->timer_,
+                               DEFAULT_TIMER_INTERVAL_MS / 1000.0);
+    }
     if (!plugin->timer_) {
       LOG_DEBUG("add timer to update position of playing audio");
-      plugin->timer_ = ecore_timer_add(TIMEOUT, UpdatePosition, data);
+      plugin->timer_ = ecore_timer_add(plugin->timer_interval_ms_ / 1000.0,
+                                       UpdatePosition, data);
       if (plugin->timer_ == nullptr) {
         LOG_ERROR("failed to add timer for UpdatePosition");
       }
     }
   }
 
+  // Sends the positions of the playing players whose update interval has
+  // passed, either as one audio.onCurrentPosition call per player or, if
+  // batching is enabled, as a single audio.onCurrentPositions call. The
+  // duration is sent only once when the player is prepared.
   static Eina_Bool UpdatePosition(void *data) {
     AudioplayersTizenPlugin *plugin = (AudioplayersTizenPlugin *)data;
-    bool none_playing = true;
-    auto iter = plugin->audio_players_.begin();
-    while (iter != plugin->audio_players_.end()) {
+    double now = ecore_time_get();
+    // A player is due if its next update is closer than half a tick away.
+    double slack_ms = plugin->timer_interval_ms_ / 2.0;
+    int min_interval_ms = 0;
+    flutter::EncodableMap positions;
+    for (auto &iter : plugin->audio_players_) {
+      AudioPlayer *player = iter.second.get();
       try {
-        std::string player_id = iter->second->GetPlayerId();
-        if (iter->second->IsPlaying()) {
-          LOG_DEBUG("Audio player %s is playing", player_id.c_str());
-          none_playing = false;
-          flutter::EncodableMap duration = {
-              {flutter::EncodableValue("playerId"),
-               flutter::EncodableValue(player_id)},
-              {flutter::EncodableValue("value"),
-               flutter::EncodableValue(iter->second->GetDuration())}};
-          plugin->channel_->InvokeMethod(
-              "audio.onDuration",
-              std::make_unique<flutter::EncodableValue>(duration));
+        int interval_ms = player->GetPositionUpdateInterval();
+        if (interval_ms <= 0 || !player->IsPlaying()) {
+          continue;
+        }
+        if (min_interval_ms == 0 || interval_ms < min_interval_ms) {
+          min_interval_ms = interval_ms;
+        }
+        double elapsed_ms = (now - player->GetLastPositionUpdateTime()) * 1000;
+        if (elapsed_ms + slack_ms < interval_ms) {
+          continue;
+        }
+        player->SetLastPositionUpdateTime(now);
 
-          flutter::EncodableMap position = {
-              {flutter::EncodableValue("playerId"),
-               flutter::EncodableValue(player_id)},
-              {flutter::EncodableValue("value"),
-               flutter::EncodableValue(iter->second->GetCurrentPosition())}};
+        flutter::EncodableValue player_id(player->GetPlayerId());
+        flutter::EncodableValue position(player->GetCurrentPosition());
+        if (plugin->batch_position_updates_) {
+          positions[player_id] = position;
+        } else {
+          flutter::EncodableMap wrapped = {
+              {flutter::EncodableValue("playerId"), player_id},
+              {flutter::EncodableValue("value"), position}};
           plugin->channel_->InvokeMethod(
               "audio.onCurrentPosition",
-              std::make_unique<flutter::EncodableValue>(position));
+              std::make_unique<flutter::EncodableValue>(wrapped));
         }
-        iter++;
       } catch (...) {
         LOG_ERROR("failed to update position for player %s",
-                  iter->second->GetPlayerId().c_str());
+                  player->GetPlayerId().c_str());
       }
     }
 
-    if (none_playing) {
+    if (!positions.empty()) {
+      flutter::EncodableMap wrapped = {{flutter::EncodableValue("value"),
+                                        flutter::EncodableValue(positions)}};
+      plugin->channel_->InvokeMethod(
+          "audio.onCurrentPositions",
+          std::make_unique<flutter::EncodableValue>(wrapped));
+    }
+
+    if (min_interval_ms == 0) {
+      // No playing player wants updates.
       plugin->timer_ = nullptr;
       return ECORE_CALLBACK_CANCEL;
-    } else {
-      return ECORE_CALLBACK_RENEW;
     }
+    if (min_interval_ms != plugin->timer_interval_ms_) {
+      plugin->timer_interval_ms_ = min_interval_ms;
+      ecore_timer_interval_set(plugin->timer_, min_interval_ms / 1000.0);
+    }
+    return ECORE_CALLBACK_RENEW;
   }
 
   Ecore_Timer *timer_;
+  int timer_interval_ms_;
+  bool batch_position_updates_;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  AudioDataRegistry audio_data_registry_;
   std::map<std::string, std::unique_ptr<AudioPlayer>> audio_players_;
+  std::unique_ptr<SoundPool> sound_pool_;
 };
 
 void AudioplayersTizenPluginRegisterWithRegistrar(
@@ -0,0 +1,117 @@
+#include "pcm_mixer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define GAIN_SHIFT 12
+#define UNITY_GAIN (1 << GAIN_SHIFT)
+
+PcmMixer::PcmMixer(int channels, size_t max_voices)
+    : channels_(channels), voices_(max_voices) {}
+
+int PcmMixer::Play(std::shared_ptr<const PcmBuffer> clip, double volume,
+                   bool loop) {
+  if (!clip || clip->empty() || voices_.empty()) {
+    return -1;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  Voice *target = nullptr;
+  for (Voice &voice : voices_) {
+    if (!voice.clip) {
+      target = &voice;
+      break;
+    }
+    if (!target || voice.start_order < target->start_order) {
+      target = &voice;
+    }
+  }
+  target->clip = std::move(clip);
+  target->position = 0;
+  target->gain =
+      static_cast<int32_t>(std::clamp(volume, 0.0, 1.0) * UNITY_GAIN);
+  target->loop = loop;
+  target->id = next_voice_id_++;
+  target->start_order = next_start_order_++;
+  if (next_voice_id_ < 0) {
+    next_voice_id_ = 1;
+  }
+  return target->id;
+}
+
+void PcmMixer::Stop(int voice_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Voice &voice : voices_) {
+    if (voice.clip && voice.id == voice_id) {
+      voice.clip = nullptr;
+    }
+  }
+}
+
+void PcmMixer::StopClip(const PcmBuffer *clip) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Voice &voice : voices_) {
+    if (voice.clip.get() == clip) {
+      voice.clip = nullptr;
+    }
+  }
+}
+
+void PcmMixer::StopAll() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (Voice &voice : voices_) {
+    voice.clip = nullptr;
+  }
+}
+
+size_t PcmMixer::GetActiveVoiceCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return std::count_if(voices_.begin(), voices_.end(),
+                       [](const Voice &voice) { return voice.clip; });
+}
+
+void PcmMixer::Mix(int16_t *out, size_t frames) {
+  size_t samples = frames * channels_;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (accumulator_.size() < samples) {
+    accumulator_.resize(samples);
+  }
+  bool is_silent = true;
+  std::fill(accumulator_.begin(), accumulator_.begin() + samples, 0);
+
+  for (Voice &voice : voices_) {
+    if (!voice.clip) {
+      continue;
+    }
+    is_silent = false;
+    const int16_t *clip = voice.clip->data();
+    size_t clip_size = voice.clip->size();
+    int32_t gain = voice.gain;
+    size_t written = 0;
+    while (written < samples) {
+      size_t count = std::min(samples - written, clip_size - voice.position);
+      int32_t *acc = accumulator_.data() + written;
+      const int16_t *src = clip + voice.position;
+      for (size_t i = 0; i < count; i++) {
+        acc[i] += (src[i] * gain) >> GAIN_SHIFT;
+      }
+      written += count;
+      voice.position += count;
+      if (voice.position >= clip_size) {
+        if (!voice.loop) {
+          voice.clip = nullptr;
+          break;
+        }
+        voice.position = 0;
+      }
+    }
+  }
+
+  if (is_silent) {
+    memset(out, 0, samples * sizeof(int16_t));
+    return;
+  }
+  for (size_t i = 0; i < samples; i++) {
+    out[i] = static_cast<int16_t>(
+        std::clamp<int32_t>(accumulator_[i], INT16_MIN, INT16_MAX));
+  }
+}
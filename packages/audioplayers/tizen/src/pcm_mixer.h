@@ -0,0 +1,60 @@
+#ifndef PCM_MIXER_H_
+#define PCM_MIXER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Interleaved signed 16-bit PCM samples.
+using PcmBuffer = std::vector<int16_t>;
+
+// Mixes clips that are already decoded to PCM into a single interleaved
+// 16-bit stream, using a fixed number of voices. This class has no platform
+// dependency.
+//
+// All methods are thread-safe, so that Mix() can be called from an audio
+// output thread while the other methods are called from the main thread.
+class PcmMixer {
+ public:
+  PcmMixer(int channels, size_t max_voices);
+  ~PcmMixer() = default;
+
+  int GetChannels() const { return channels_; }
+
+  // Starts playing |clip|, which must have the mixer's channel count and
+  // sample rate, at |volume| (0.0 to 1.0). Returns the ID of the voice. If
+  // all voices are busy, the voice that started first is replaced.
+  int Play(std::shared_ptr<const PcmBuffer> clip, double volume, bool loop);
+  void Stop(int voice_id);
+  // Stops all voices that play |clip|.
+  void StopClip(const PcmBuffer *clip);
+  void StopAll();
+  size_t GetActiveVoiceCount();
+
+  // Writes |frames| frames of the mixed voices to |out|, or silence if no
+  // voice is active. Voices that reach the end of a non-looping clip stop.
+  void Mix(int16_t *out, size_t frames);
+
+ private:
+  struct Voice {
+    std::shared_ptr<const PcmBuffer> clip;
+    // The index of the next sample in |clip|.
+    size_t position = 0;
+    // The volume in 1/4096 units.
+    int32_t gain = 0;
+    bool loop = false;
+    int id = 0;
+    uint64_t start_order = 0;
+  };
+
+  int channels_;
+  std::mutex mutex_;
+  std::vector<Voice> voices_;
+  std::vector<int32_t> accumulator_;
+  int next_voice_id_ = 1;
+  uint64_t next_start_order_ = 0;
+};
+
+#endif  // PCM_MIXER_H_
@@ -0,0 +1,168 @@
+#include "sound_pool.h"
+
+#include <Ecore.h>
+
+#include "audio_player_error.h"
+#include "log.h"
+#include "wav_decoder.h"
+
+#define SAMPLE_RATE 44100
+#define CHANNELS 2
+#define MAX_VOICES 16
+// The output is paused after no voice has been active for two consecutive
+// checks, so that the end of the last sound has left the device buffer.
+#define IDLE_CHECK_INTERVAL_SEC 0.5
+
+SoundPool::SoundPool() : mixer_(CHANNELS, MAX_VOICES) {}
+
+SoundPool::~SoundPool() { Release(); }
+
+int SoundPool::Load(const uint8_t *data, size_t size) {
+  auto pcm = std::make_shared<PcmBuffer>();
+  if (!DecodeWav(data, size, SAMPLE_RATE, CHANNELS, *pcm)) {
+    throw AudioPlayerError("Unsupported format",
+                           "Only WAVE files with PCM samples can be loaded");
+  }
+  int sound_id = next_sound_id_++;
+  sounds_[sound_id] = std::move(pcm);
+  LOG_DEBUG("loaded sound %d", sound_id);
+  return sound_id;
+}
+
+void SoundPool::Unload(int sound_id) {
+  auto iter = sounds_.find(sound_id);
+  if (iter == sounds_.end()) {
+    return;
+  }
+  mixer_.StopClip(iter->second.get());
+  sounds_.erase(iter);
+  if (sounds_.empty()) {
+    UnprepareOutput();
+  }
+}
+
+int SoundPool::Play(int sound_id, double volume, bool loop) {
+  auto iter = sounds_.find(sound_id);
+  if (iter == sounds_.end()) {
+    throw AudioPlayerError("Invalid sound ID",
+                           "No sound is loaded with ID " +
+                               std::to_string(sound_id));
+  }
+  PrepareOutput();
+  int voice_id = mixer_.Play(iter->second, volume, loop);
+  ResumeOutput();
+  return voice_id;
+}
+
+void SoundPool::Stop(int voice_id) { mixer_.Stop(voice_id); }
+
+void SoundPool::Release() {
+  StopIdleCheck();
+  mixer_.StopAll();
+  UnprepareOutput();
+  if (output_) {
+    audio_out_destroy(output_);
+    output_ = nullptr;
+  }
+  sounds_.clear();
+}
+
+void SoundPool::PrepareOutput() {
+  if (is_prepared_) {
+    return;
+  }
+  int ret;
+  if (!output_) {
+    ret = audio_out_create_new(SAMPLE_RATE, AUDIO_CHANNEL_STEREO,
+                               AUDIO_SAMPLE_TYPE_S16_LE, &output_);
+    if (ret != AUDIO_IO_ERROR_NONE) {
+      output_ = nullptr;
+      throw AudioPlayerError(get_error_message(ret),
+                             "audio_out_create_new failed");
+    }
+    ret = audio_out_set_stream_cb(output_, OnStreamRequested, this);
+    if (ret != AUDIO_IO_ERROR_NONE) {
+      throw AudioPlayerError(get_error_message(ret),
+                             "audio_out_set_stream_cb failed");
+    }
+  }
+  ret = audio_out_prepare(output_);
+  if (ret != AUDIO_IO_ERROR_NONE) {
+    throw AudioPlayerError(get_error_message(ret), "audio_out_prepare failed");
+  }
+  is_prepared_ = true;
+}
+
+void SoundPool::UnprepareOutput() {
+  StopIdleCheck();
+  if (!is_prepared_) {
+    return;
+  }
+  // Waits for the stream callback to return.
+  int ret = audio_out_unprepare(output_);
+  if (ret != AUDIO_IO_ERROR_NONE) {
+    LOG_ERROR("audio_out_unprepare failed : %s", get_error_message(ret));
+  }
+  is_prepared_ = false;
+  is_paused_ = false;
+}
+
+void SoundPool::ResumeOutput() {
+  if (is_paused_) {
+    int ret = audio_out_resume(output_);
+    if (ret != AUDIO_IO_ERROR_NONE) {
+      LOG_ERROR("audio_out_resume failed : %s", get_error_message(ret));
+    }
+    is_paused_ = false;
+  }
+  was_idle_ = false;
+  if (!idle_timer_) {
+    idle_timer_ = ecore_timer_add(IDLE_CHECK_INTERVAL_SEC, OnIdleCheck, this);
+  }
+}
+
+void SoundPool::StopIdleCheck() {
+  if (idle_timer_) {
+    ecore_timer_del(idle_timer_);
+    idle_timer_ = nullptr;
+  }
+}
+
+Eina_Bool SoundPool::OnIdleCheck(void *data) {
+  SoundPool *self = reinterpret_cast<SoundPool *>(data);
+  if (self->mixer_.GetActiveVoiceCount() > 0) {
+    self->was_idle_ = false;
+    return ECORE_CALLBACK_RENEW;
+  }
+  if (!self->was_idle_) {
+    self->was_idle_ = true;
+    return ECORE_CALLBACK_RENEW;
+  }
+  // Stops the stream callback, which would otherwise keep writing silence.
+  int ret = audio_out_pause(self->output_);
+  if (ret != AUDIO_IO_ERROR_NONE) {
+    LOG_ERROR("audio_out_pause failed : %s", get_error_message(ret));
+  } else {
+    self->is_paused_ = true;
+  }
+  self->idle_timer_ = nullptr;
+  return ECORE_CALLBACK_CANCEL;
+}
+
+void SoundPool::OnStreamRequested(audio_out_h handle, size_t nbytes,
+                                  void *data) {
+  SoundPool *self = reinterpret_cast<SoundPool *>(data);
+  size_t frames = nbytes / (CHANNELS * sizeof(int16_t));
+  if (frames == 0) {
+    return;
+  }
+  if (self->mix_buffer_.size() < frames * CHANNELS) {
+    self->mix_buffer_.resize(frames * CHANNELS);
+  }
+  self->mixer_.Mix(self->mix_buffer_.data(), frames);
+  int ret = audio_out_write(handle, self->mix_buffer_.data(),
+                            frames * CHANNELS * sizeof(int16_t));
+  if (ret < 0) {
+    LOG_ERROR("audio_out_write failed : %s", get_error_message(ret));
+  }
+}
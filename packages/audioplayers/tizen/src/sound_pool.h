@@ -0,0 +1,60 @@
+#ifndef SOUND_POOL_H_
+#define SOUND_POOL_H_
+
+#include <Ecore.h>
+#include <audio_io.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "pcm_mixer.h"
+
+// Plays short sounds with low latency. Each sound is decoded to PCM once when
+// loaded and kept in memory, and the playing sounds are mixed into a single
+// audio output stream instead of using a player per sound.
+class SoundPool {
+ public:
+  SoundPool();
+  ~SoundPool();
+
+  // Decodes |data| and returns the ID of the loaded sound. |data| is not
+  // referenced after this call.
+  int Load(const uint8_t *data, size_t size);
+  // Stops the voices playing the sound and releases it.
+  void Unload(int sound_id);
+
+  // Returns the ID of the voice playing the sound.
+  int Play(int sound_id, double volume, bool loop);
+  void Stop(int voice_id);
+  // Stops all voices, unloads all sounds and releases the audio output.
+  void Release();
+
+ private:
+  void PrepareOutput();
+  void UnprepareOutput();
+  // Resumes the output if it is paused, and pauses it again once all voices
+  // have stopped.
+  void ResumeOutput();
+  void StopIdleCheck();
+
+  static Eina_Bool OnIdleCheck(void *data);
+
+  static void OnStreamRequested(audio_out_h handle, size_t nbytes,
+                                void *data);
+
+  PcmMixer mixer_;
+  std::map<int, std::shared_ptr<const PcmBuffer>> sounds_;
+  int next_sound_id_ = 1;
+  audio_out_h output_ = nullptr;
+  bool is_prepared_ = false;
+  bool is_paused_ = false;
+  Ecore_Timer *idle_timer_ = nullptr;
+  bool was_idle_ = false;
+  // Only accessed by the audio output thread.
+  std::vector<int16_t> mix_buffer_;
+};
+
+#endif  // SOUND_POOL_H_
@@ -0,0 +1,139 @@
+#include "wav_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_IEEE_FLOAT 3
+#define WAVE_FORMAT_EXTENSIBLE 0xFFFE
+
+namespace {
+
+uint16_t ReadLe16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+uint32_t ReadLe32(const uint8_t *p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) |
+         (static_cast<uint32_t>(p[3]) << 24);
+}
+
+struct WavFormat {
+  uint16_t format = 0;
+  uint16_t channels = 0;
+  uint32_t sample_rate = 0;
+  uint16_t bits_per_sample = 0;
+};
+
+// Reads one sample of |format| at |p| as a 16-bit value.
+int16_t ReadSample(const WavFormat &format, const uint8_t *p) {
+  if (format.format == WAVE_FORMAT_IEEE_FLOAT) {
+    float value;
+    memcpy(&value, p, sizeof(value));
+    return static_cast<int16_t>(std::clamp(value, -1.0f, 1.0f) * INT16_MAX);
+  }
+  switch (format.bits_per_sample) {
+    case 8:
+      // 8-bit samples are unsigned.
+      return static_cast<int16_t>((p[0] - 128) << 8);
+    case 16:
+      return static_cast<int16_t>(ReadLe16(p));
+    default:
+      // 24-bit, keeping the upper 16 bits.
+      return static_cast<int16_t>(ReadLe16(p + 1));
+  }
+}
+
+}  // namespace
+
+bool DecodeWav(const uint8_t *data, size_t size, int sample_rate,
+               int channels, PcmBuffer &out) {
+  if (size < 12 || memcmp(data, "RIFF", 4) != 0 ||
+      memcmp(data + 8, "WAVE", 4) != 0 || sample_rate <= 0 ||
+      (channels != 1 && channels != 2)) {
+    return false;
+  }
+
+  WavFormat format;
+  const uint8_t *samples = nullptr;
+  size_t samples_size = 0;
+  size_t offset = 12;
+  while (offset + 8 <= size) {
+    const uint8_t *chunk = data + offset;
+    size_t chunk_size = ReadLe32(chunk + 4);
+    size_t available = std::min(chunk_size, size - offset - 8);
+    if (memcmp(chunk, "fmt ", 4) == 0 && available >= 16) {
+      format.format = ReadLe16(chunk + 8);
+      format.channels = ReadLe16(chunk + 10);
+      format.sample_rate = ReadLe32(chunk + 12);
+      format.bits_per_sample = ReadLe16(chunk + 22);
+      if (format.format == WAVE_FORMAT_EXTENSIBLE && available >= 26) {
+        // The first two bytes of the subformat GUID are the format code.
+        format.format = ReadLe16(chunk + 32);
+      }
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      samples = chunk + 8;
+      samples_size = available;
+      break;
+    }
+    // Chunks are padded to an even size.
+    offset += 8 + chunk_size + (chunk_size & 1);
+  }
+
+  bool is_supported_format =
+      (format.format == WAVE_FORMAT_PCM &&
+       (format.bits_per_sample == 8 || format.bits_per_sample == 16 ||
+        format.bits_per_sample == 24)) ||
+      (format.format == WAVE_FORMAT_IEEE_FLOAT &&
+       format.bits_per_sample == 32);
+  if (!samples || !is_supported_format || format.channels == 0 ||
+      format.sample_rate == 0) {
+    return false;
+  }
+
+  size_t frame_size = format.channels * (format.bits_per_sample / 8);
+  size_t src_frames = samples_size / frame_size;
+  if (src_frames == 0) {
+    return false;
+  }
+
+  // Converts the source to |channels| channels at the source rate first.
+  PcmBuffer converted(src_frames * channels);
+  for (size_t i = 0; i < src_frames; i++) {
+    const uint8_t *frame = samples + i * frame_size;
+    int16_t left = ReadSample(format, frame);
+    int16_t right = format.channels > 1
+                        ? ReadSample(format, frame + frame_size /
+                                                         format.channels)
+                        : left;
+    if (channels == 1) {
+      converted[i] = static_cast<int16_t>((left + right) / 2);
+    } else {
+      converted[i * 2] = left;
+      converted[i * 2 + 1] = right;
+    }
+  }
+
+  if (format.sample_rate == static_cast<uint32_t>(sample_rate)) {
+    out = std::move(converted);
+    return true;
+  }
+
+  size_t dst_frames = static_cast<size_t>(
+      static_cast<uint64_t>(src_frames) * sample_rate / format.sample_rate);
+  out.resize(dst_frames * channels);
+  // The source position of each destination frame in 16.16 fixed point.
+  uint64_t step = (static_cast<uint64_t>(format.sample_rate) << 16) /
+                  static_cast<uint64_t>(sample_rate);
+  uint64_t position = 0;
+  for (size_t i = 0; i < dst_frames; i++, position += step) {
+    size_t index = std::min<size_t>(position >> 16, src_frames - 1);
+    size_t next = std::min(index + 1, src_frames - 1);
+    int32_t fraction = position & 0xFFFF;
+    for (int c = 0; c < channels; c++) {
+      int32_t a = converted[index * channels + c];
+      int32_t b = converted[next * channels + c];
+      out[i * channels + c] =
+          static_cast<int16_t>(a + (((b - a) * fraction) >> 16));
+    }
+  }
+  return true;
+}
@@ -0,0 +1,17 @@
+#ifndef WAV_DECODER_H_
+#define WAV_DECODER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pcm_mixer.h"
+
+// Decodes a RIFF WAVE file with 8, 16 or 24-bit integer or 32-bit float PCM
+// samples to interleaved 16-bit PCM with |channels| channels (1 or 2) at
+// |sample_rate|. The channel count is converted by duplicating or averaging,
+// and the sample rate by linear interpolation. Returns false if |data| is not
+// a supported WAVE file. This function has no platform dependency.
+bool DecodeWav(const uint8_t *data, size_t size, int sample_rate,
+               int channels, PcmBuffer &out);
+
+#endif  // WAV_DECODER_H_
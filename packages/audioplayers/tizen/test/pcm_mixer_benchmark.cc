@@ -0,0 +1,73 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "pcm_mixer.h"
+#include "wav_decoder.h"
+
+namespace {
+
+void Measure(const char *name, int iterations,
+             const std::function<void()> &function) {
+  function();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    function();
+  }
+  std::chrono::duration<double, std::micro> elapsed =
+      std::chrono::steady_clock::now() - start;
+  printf("%-36s %10.2f us\n", name, elapsed.count() / iterations);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 2000;
+  const int kChannels = 2;
+  const size_t kFrames = 1024;
+  const int kVoices = 16;
+
+  // Clips of different lengths, so that the voices wrap at different times.
+  std::vector<std::shared_ptr<const PcmBuffer>> clips;
+  for (int i = 0; i < kVoices; i++) {
+    auto clip = std::make_shared<PcmBuffer>((4410 + i * 331) * kChannels);
+    for (size_t j = 0; j < clip->size(); j++) {
+      (*clip)[j] = static_cast<int16_t>(j * (i + 1) * 37);
+    }
+    clips.push_back(std::move(clip));
+  }
+  std::vector<int16_t> out(kFrames * kChannels);
+
+  printf("%zu frames per call, %d iterations\n", kFrames, iterations);
+  for (int voices : {1, 4, kVoices}) {
+    PcmMixer mixer(kChannels, kVoices);
+    for (int i = 0; i < voices; i++) {
+      mixer.Play(clips[i], 0.8, true);
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "Mix, %d voice(s)", voices);
+    Measure(name, iterations, [&]() { mixer.Mix(out.data(), kFrames); });
+  }
+
+  // One second of 48 kHz stereo, resampled to the mixer format.
+  std::vector<uint8_t> wav = {'R', 'I', 'F', 'F', 0, 0, 0, 0, 'W', 'A',
+                              'V', 'E', 'f', 'm', 't', ' ', 16, 0, 0, 0,
+                              1,   0,   2,   0,   0x80, 0xBB, 0, 0};
+  const uint8_t kFormatTail[] = {0x00, 0xEE, 0x02, 0x00, 4, 0, 16, 0};
+  wav.insert(wav.end(), kFormatTail, kFormatTail + sizeof(kFormatTail));
+  const uint32_t data_size = 48000 * 4;
+  const uint8_t kDataHeader[] = {'d', 'a', 't', 'a',
+                                 data_size & 0xFF, (data_size >> 8) & 0xFF,
+                                 (data_size >> 16) & 0xFF, data_size >> 24};
+  wav.insert(wav.end(), kDataHeader, kDataHeader + sizeof(kDataHeader));
+  for (uint32_t i = 0; i < data_size; i++) {
+    wav.push_back(static_cast<uint8_t>(i * 13));
+  }
+  PcmBuffer pcm;
+  Measure("DecodeWav, 1 s 48 kHz to 44.1 kHz", iterations / 100 + 1,
+          [&]() { DecodeWav(wav.data(), wav.size(), 44100, 2, pcm); });
+  return 0;
+}
@@ -0,0 +1,191 @@
+#include "pcm_mixer.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+std::shared_ptr<const PcmBuffer> CreateClip(size_t samples, int16_t value) {
+  return std::make_shared<const PcmBuffer>(samples, value);
+}
+
+std::vector<int16_t> Mix(PcmMixer &mixer, size_t frames) {
+  std::vector<int16_t> out(frames * mixer.GetChannels(), 0x5555);
+  mixer.Mix(out.data(), frames);
+  return out;
+}
+
+void TestSilence() {
+  PcmMixer mixer(2, 4);
+  std::vector<int16_t> out = Mix(mixer, 16);
+  for (int16_t sample : out) {
+    EXPECT(sample == 0, "an idle mixer wrote %d", sample);
+  }
+  EXPECT(mixer.Play(std::make_shared<const PcmBuffer>(), 1.0, false) == -1,
+         "an empty clip was played");
+  EXPECT(mixer.Play(nullptr, 1.0, false) == -1, "a null clip was played");
+  EXPECT(mixer.GetActiveVoiceCount() == 0, "%zu active voices",
+         mixer.GetActiveVoiceCount());
+}
+
+void TestVolume() {
+  PcmMixer mixer(1, 4);
+  auto clip = CreateClip(4, 20000);
+  mixer.Play(clip, 0.5, false);
+  EXPECT(Mix(mixer, 1)[0] == 10000, "half volume");
+  mixer.StopAll();
+  mixer.Play(clip, 2.0, false);
+  EXPECT(Mix(mixer, 1)[0] == 20000, "a volume above 1.0 is not clamped");
+  mixer.StopAll();
+  mixer.Play(clip, -1.0, false);
+  EXPECT(Mix(mixer, 1)[0] == 0, "a negative volume is not clamped");
+}
+
+void TestStealOldestVoice() {
+  PcmMixer mixer(1, 2);
+  auto a = CreateClip(100, 100);
+  auto b = CreateClip(100, 1000);
+  auto c = CreateClip(100, 10000);
+  int a_id = mixer.Play(a, 1.0, true);
+  int b_id = mixer.Play(b, 1.0, true);
+  int c_id = mixer.Play(c, 1.0, true);
+  EXPECT(a_id != b_id && b_id != c_id && a_id != c_id, "voice IDs %d %d %d",
+         a_id, b_id, c_id);
+  EXPECT(mixer.GetActiveVoiceCount() == 2, "%zu active voices",
+         mixer.GetActiveVoiceCount());
+  EXPECT(Mix(mixer, 1)[0] == 11000, "the oldest voice was not replaced");
+  // The replaced voice is gone, so stopping it must not stop another one.
+  mixer.Stop(a_id);
+  EXPECT(mixer.GetActiveVoiceCount() == 2, "%zu active voices",
+         mixer.GetActiveVoiceCount());
+
+  // A voice that was freed is reused before any voice is stolen, and the
+  // oldest remaining voice is stolen next.
+  mixer.Stop(b_id);
+  int d_id = mixer.Play(a, 1.0, true);
+  EXPECT(Mix(mixer, 1)[0] == 10100, "a free voice was not reused");
+  mixer.Play(b, 1.0, true);
+  EXPECT(Mix(mixer, 1)[0] == 1100, "the oldest voice was not replaced");
+  mixer.Stop(d_id);
+  EXPECT(Mix(mixer, 1)[0] == 1000, "Stop() stopped the wrong voice");
+}
+
+void TestLoopWrap() {
+  PcmMixer mixer(1, 2);
+  auto clip = std::make_shared<const PcmBuffer>(PcmBuffer{1, 2, 3});
+  mixer.Play(clip, 1.0, true);
+  std::vector<int16_t> out = Mix(mixer, 7);
+  const int16_t expected[] = {1, 2, 3, 1, 2, 3, 1};
+  for (size_t i = 0; i < out.size(); i++) {
+    EXPECT(out[i] == expected[i], "sample %zu is %d", i, out[i]);
+  }
+  // The position carries over to the next call.
+  out = Mix(mixer, 2);
+  EXPECT(out[0] == 2 && out[1] == 3, "continued with %d %d", out[0], out[1]);
+  EXPECT(mixer.GetActiveVoiceCount() == 1, "a looping voice stopped");
+
+  // A clip shorter than a buffer wraps several times within one call.
+  out = Mix(mixer, 9);
+  for (size_t i = 0; i < out.size(); i++) {
+    EXPECT(out[i] == expected[i % 3], "sample %zu is %d", i, out[i]);
+  }
+}
+
+void TestEndOfClip() {
+  PcmMixer mixer(2, 2);
+  auto clip = std::make_shared<const PcmBuffer>(PcmBuffer{1, 2, 3, 4});
+  mixer.Play(clip, 1.0, false);
+  std::vector<int16_t> out = Mix(mixer, 4);
+  const int16_t expected[] = {1, 2, 3, 4, 0, 0, 0, 0};
+  for (size_t i = 0; i < out.size(); i++) {
+    EXPECT(out[i] == expected[i], "sample %zu is %d", i, out[i]);
+  }
+  EXPECT(mixer.GetActiveVoiceCount() == 0, "a finished voice is active");
+}
+
+void TestSaturation() {
+  PcmMixer mixer(1, 4);
+  mixer.Play(CreateClip(8, 30000), 1.0, false);
+  mixer.Play(CreateClip(8, 30000), 1.0, false);
+  EXPECT(Mix(mixer, 1)[0] == INT16_MAX, "positive overflow is not clamped");
+  mixer.StopAll();
+  mixer.Play(CreateClip(8, -30000), 1.0, false);
+  mixer.Play(CreateClip(8, -30000), 1.0, false);
+  mixer.Play(CreateClip(8, -30000), 1.0, false);
+  EXPECT(Mix(mixer, 1)[0] == INT16_MIN, "negative overflow is not clamped");
+  mixer.StopAll();
+  // Full scale voices that cancel out do not clip on the way.
+  mixer.Play(CreateClip(8, INT16_MAX), 1.0, false);
+  mixer.Play(CreateClip(8, INT16_MAX), 1.0, false);
+  mixer.Play(CreateClip(8, INT16_MIN), 1.0, false);
+  mixer.Play(CreateClip(8, INT16_MIN), 1.0, false);
+  EXPECT(Mix(mixer, 1)[0] == -2, "the sum is %d", Mix(mixer, 1)[0]);
+}
+
+void TestStopClip() {
+  PcmMixer mixer(1, 4);
+  auto a = CreateClip(100, 100);
+  auto b = CreateClip(100, 1000);
+  mixer.Play(a, 1.0, true);
+  mixer.Play(a, 1.0, false);
+  mixer.Play(b, 1.0, true);
+  EXPECT(mixer.GetActiveVoiceCount() == 3, "%zu active voices",
+         mixer.GetActiveVoiceCount());
+  mixer.StopClip(a.get());
+  EXPECT(mixer.GetActiveVoiceCount() == 1, "%zu active voices",
+         mixer.GetActiveVoiceCount());
+  EXPECT(Mix(mixer, 1)[0] == 1000, "the other clip was stopped");
+  mixer.StopAll();
+  EXPECT(mixer.GetActiveVoiceCount() == 0, "%zu active voices",
+         mixer.GetActiveVoiceCount());
+}
+
+// Mixes on one thread while voices are started and stopped on another, as
+// the audio output thread and the main thread do.
+void TestConcurrentMix() {
+  PcmMixer mixer(2, 4);
+  auto clip = CreateClip(300, 1000);
+  std::atomic<bool> is_done{false};
+  std::thread output([&]() {
+    std::vector<int16_t> out(256 * 2);
+    while (!is_done) {
+      mixer.Mix(out.data(), 256);
+      for (int16_t sample : out) {
+        if (sample < 0 || sample > 4000) {
+          failures++;
+          printf("mixed an invalid sample %d\n", sample);
+          return;
+        }
+      }
+    }
+  });
+  for (int i = 0; i < 20000; i++) {
+    int id = mixer.Play(clip, 1.0, i % 3 == 0);
+    if (i % 2 == 0) {
+      mixer.Stop(id);
+    }
+    if (i % 100 == 0) {
+      mixer.StopClip(clip.get());
+    }
+  }
+  is_done = true;
+  output.join();
+}
+
+}  // namespace
+
+int main() {
+  TestSilence();
+  TestVolume();
+  TestStealOldestVoice();
+  TestLoopWrap();
+  TestEndOfClip();
+  TestSaturation();
+  TestStopClip();
+  TestConcurrentMix();
+  return ReportTestResult();
+}
@@ -0,0 +1,271 @@
+#include "wav_decoder.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+#define WAVE_FORMAT_PCM 1
+#define WAVE_FORMAT_ADPCM 2
+#define WAVE_FORMAT_IEEE_FLOAT 3
+
+void Append16(std::vector<uint8_t> &out, uint16_t value) {
+  out.push_back(value & 0xFF);
+  out.push_back(value >> 8);
+}
+
+void Append32(std::vector<uint8_t> &out, uint32_t value) {
+  Append16(out, value & 0xFFFF);
+  Append16(out, value >> 16);
+}
+
+void AppendTag(std::vector<uint8_t> &out, const char *tag) {
+  for (int i = 0; i < 4; i++) {
+    out.push_back(tag[i]);
+  }
+}
+
+struct WavSpec {
+  uint16_t format = WAVE_FORMAT_PCM;
+  uint16_t channels = 1;
+  uint32_t sample_rate = 44100;
+  uint16_t bits_per_sample = 16;
+  bool is_extensible = false;
+  // An odd-sized chunk before "fmt ", which must be skipped with padding.
+  bool has_extra_chunk = false;
+};
+
+std::vector<uint8_t> CreateWav(const WavSpec &spec,
+                               const std::vector<uint8_t> &samples) {
+  std::vector<uint8_t> wav;
+  AppendTag(wav, "RIFF");
+  Append32(wav, 0);
+  AppendTag(wav, "WAVE");
+  if (spec.has_extra_chunk) {
+    AppendTag(wav, "LIST");
+    Append32(wav, 3);
+    wav.insert(wav.end(), {'a', 'b', 'c', 0});
+  }
+  AppendTag(wav, "fmt ");
+  Append32(wav, spec.is_extensible ? 40 : 16);
+  Append16(wav, spec.is_extensible ? 0xFFFE : spec.format);
+  Append16(wav, spec.channels);
+  Append32(wav, spec.sample_rate);
+  uint16_t block_align = spec.channels * spec.bits_per_sample / 8;
+  Append32(wav, spec.sample_rate * block_align);
+  Append16(wav, block_align);
+  Append16(wav, spec.bits_per_sample);
+  if (spec.is_extensible) {
+    Append16(wav, 22);
+    Append16(wav, spec.bits_per_sample);
+    Append32(wav, spec.channels == 2 ? 3 : 4);
+    // KSDATAFORMAT_SUBTYPE_PCM or _IEEE_FLOAT.
+    Append16(wav, spec.format);
+    const uint8_t kGuidTail[] = {0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80,
+                                 0x00, 0x00, 0xAA, 0x00, 0x38, 0x9B, 0x71};
+    wav.insert(wav.end(), kGuidTail, kGuidTail + sizeof(kGuidTail));
+  }
+  AppendTag(wav, "data");
+  Append32(wav, samples.size());
+  wav.insert(wav.end(), samples.begin(), samples.end());
+  uint32_t riff_size = wav.size() - 8;
+  memcpy(&wav[4], &riff_size, 4);
+  return wav;
+}
+
+std::vector<uint8_t> Int16Samples(const std::vector<int16_t> &values) {
+  std::vector<uint8_t> bytes;
+  for (int16_t value : values) {
+    Append16(bytes, static_cast<uint16_t>(value));
+  }
+  return bytes;
+}
+
+bool Decode(const std::vector<uint8_t> &wav, int sample_rate, int channels,
+            PcmBuffer &out) {
+  return DecodeWav(wav.data(), wav.size(), sample_rate, channels, out);
+}
+
+void ExpectSamples(const PcmBuffer &actual,
+                   const std::vector<int16_t> &expected, const char *name) {
+  EXPECT(actual.size() == expected.size(), "%s: %zu samples, expected %zu",
+         name, actual.size(), expected.size());
+  for (size_t i = 0; i < actual.size() && i < expected.size(); i++) {
+    EXPECT(actual[i] == expected[i], "%s: sample %zu is %d, expected %d", name,
+           i, actual[i], expected[i]);
+  }
+}
+
+void TestSampleFormats() {
+  PcmBuffer out;
+  WavSpec spec;
+  spec.bits_per_sample = 8;
+  // 8-bit samples are unsigned.
+  EXPECT(Decode(CreateWav(spec, {0, 128, 255}), 44100, 1, out), "8-bit");
+  ExpectSamples(out, {-32768, 0, 32512}, "8-bit");
+
+  spec.bits_per_sample = 16;
+  EXPECT(Decode(CreateWav(spec, Int16Samples({-32768, 0, 32767, 1234})),
+                44100, 1, out),
+         "16-bit");
+  ExpectSamples(out, {-32768, 0, 32767, 1234}, "16-bit");
+
+  spec.bits_per_sample = 24;
+  // Little endian 0x123456 and 0xFEDCBA keep their upper 16 bits.
+  EXPECT(Decode(CreateWav(spec, {0x56, 0x34, 0x12, 0xBA, 0xDC, 0xFE}), 44100,
+                1, out),
+         "24-bit");
+  ExpectSamples(out, {0x1234, static_cast<int16_t>(0xFEDC)}, "24-bit");
+
+  spec.format = WAVE_FORMAT_IEEE_FLOAT;
+  spec.bits_per_sample = 32;
+  std::vector<uint8_t> floats;
+  for (float value : {-1.0f, 0.0f, 0.5f, 2.0f, -3.0f}) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    Append32(floats, bits);
+  }
+  EXPECT(Decode(CreateWav(spec, floats), 44100, 1, out), "float");
+  ExpectSamples(out, {-32767, 0, 16383, 32767, -32767}, "float");
+
+  spec.is_extensible = true;
+  EXPECT(Decode(CreateWav(spec, floats), 44100, 1, out), "extensible float");
+  ExpectSamples(out, {-32767, 0, 16383, 32767, -32767}, "extensible float");
+
+  spec.format = WAVE_FORMAT_PCM;
+  spec.bits_per_sample = 16;
+  spec.channels = 2;
+  EXPECT(Decode(CreateWav(spec, Int16Samples({1, -1, 2, -2})), 44100, 2, out),
+         "extensible 16-bit");
+  ExpectSamples(out, {1, -1, 2, -2}, "extensible 16-bit");
+}
+
+void TestChannels() {
+  PcmBuffer out;
+  WavSpec spec;
+  EXPECT(Decode(CreateWav(spec, Int16Samples({100, -200})), 44100, 2, out),
+         "mono to stereo");
+  ExpectSamples(out, {100, 100, -200, -200}, "mono to stereo");
+
+  spec.channels = 2;
+  std::vector<uint8_t> stereo = Int16Samples({1000, 3000, -32768, -32768});
+  EXPECT(Decode(CreateWav(spec, stereo), 44100, 1, out), "stereo to mono");
+  ExpectSamples(out, {2000, -32768}, "stereo to mono");
+  EXPECT(Decode(CreateWav(spec, stereo), 44100, 2, out), "stereo");
+  ExpectSamples(out, {1000, 3000, -32768, -32768}, "stereo");
+
+  // Only the first two channels of a multichannel file are used.
+  spec.channels = 4;
+  EXPECT(Decode(CreateWav(spec, Int16Samples({1, 2, 3, 4, 5, 6, 7, 8})),
+                44100, 2, out),
+         "4 channels");
+  ExpectSamples(out, {1, 2, 5, 6}, "4 channels");
+}
+
+void TestResampling() {
+  PcmBuffer out;
+  WavSpec spec;
+  spec.sample_rate = 22050;
+  std::vector<int16_t> ramp;
+  for (int i = 0; i < 100; i++) {
+    ramp.push_back(i * 100);
+  }
+  EXPECT(Decode(CreateWav(spec, Int16Samples(ramp)), 44100, 2, out),
+         "upsampling");
+  EXPECT(out.size() == 400, "upsampled to %zu samples", out.size());
+  // Every other frame is interpolated halfway.
+  for (size_t i = 0; i + 2 < out.size() / 2; i++) {
+    int expected = i % 2 == 0 ? ramp[i / 2] : ramp[i / 2] + 50;
+    EXPECT(out[i * 2] == expected && out[i * 2 + 1] == expected,
+           "frame %zu is %d, expected %d", i, out[i * 2], expected);
+  }
+
+  spec.sample_rate = 48000;
+  std::vector<int16_t> constant(480, 777);
+  EXPECT(Decode(CreateWav(spec, Int16Samples(constant)), 44100, 1, out),
+         "downsampling");
+  EXPECT(out.size() == 441, "downsampled to %zu samples", out.size());
+  for (size_t i = 0; i < out.size(); i++) {
+    EXPECT(out[i] == 777, "sample %zu is %d", i, out[i]);
+  }
+
+  // The length scales with the rate ratio, rounded down.
+  for (uint32_t rate : {8000u, 11025u, 16000u, 32000u, 44100u, 96000u}) {
+    spec.sample_rate = rate;
+    std::vector<int16_t> samples(rate / 10 + 7, 1);
+    EXPECT(Decode(CreateWav(spec, Int16Samples(samples)), 44100, 1, out),
+           "%u Hz", rate);
+    size_t expected = static_cast<uint64_t>(samples.size()) * 44100 / rate;
+    EXPECT(out.size() == expected, "%u Hz: %zu samples, expected %zu", rate,
+           out.size(), expected);
+  }
+}
+
+void TestContainer() {
+  PcmBuffer out;
+  WavSpec spec;
+  spec.has_extra_chunk = true;
+  EXPECT(Decode(CreateWav(spec, Int16Samples({5, 6})), 44100, 1, out),
+         "an odd-sized chunk was not skipped");
+  ExpectSamples(out, {5, 6}, "extra chunk");
+
+  // A data chunk that claims more bytes than there are is truncated.
+  std::vector<uint8_t> wav = CreateWav(WavSpec(), Int16Samples({7, 8, 9}));
+  wav.resize(wav.size() - 1);
+  EXPECT(Decode(wav, 44100, 1, out), "truncated data");
+  ExpectSamples(out, {7, 8}, "truncated data");
+}
+
+void TestRejected() {
+  PcmBuffer out;
+  std::vector<uint8_t> wav = CreateWav(WavSpec(), Int16Samples({1, 2}));
+  EXPECT(!DecodeWav(wav.data(), 11, 44100, 1, out), "a short header");
+  EXPECT(!Decode(wav, 44100, 3, out), "3 output channels");
+  EXPECT(!Decode(wav, 0, 1, out), "a zero output rate");
+
+  std::vector<uint8_t> bad = wav;
+  bad[0] = 'X';
+  EXPECT(!Decode(bad, 44100, 1, out), "a missing RIFF tag");
+
+  WavSpec spec;
+  spec.format = WAVE_FORMAT_ADPCM;
+  spec.bits_per_sample = 4;
+  EXPECT(!Decode(CreateWav(spec, {1, 2, 3, 4}), 44100, 1, out), "ADPCM");
+
+  spec = WavSpec();
+  spec.bits_per_sample = 32;
+  EXPECT(!Decode(CreateWav(spec, {1, 2, 3, 4}), 44100, 1, out),
+         "32-bit integer PCM");
+
+  spec = WavSpec();
+  spec.format = WAVE_FORMAT_IEEE_FLOAT;
+  spec.bits_per_sample = 64;
+  EXPECT(!Decode(CreateWav(spec, std::vector<uint8_t>(8)), 44100, 1, out),
+         "64-bit float");
+
+  // A data chunk without a preceding format chunk.
+  std::vector<uint8_t> no_format;
+  AppendTag(no_format, "RIFF");
+  Append32(no_format, 16);
+  AppendTag(no_format, "WAVE");
+  AppendTag(no_format, "data");
+  Append32(no_format, 4);
+  Append32(no_format, 0);
+  EXPECT(!Decode(no_format, 44100, 1, out), "no format chunk");
+
+  EXPECT(!Decode(CreateWav(WavSpec(), {}), 44100, 1, out), "no samples");
+}
+
+}  // namespace
+
+int main() {
+  TestSampleFormats();
+  TestChannels();
+  TestResampling();
+  TestContainer();
+  TestRejected();
+  return ReportTestResult();
+}
@@ -0,0 +1,215 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "camera_capability_cache.h"
+
+#include <app_common.h>
+#include <system_info.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#include "log.h"
+
+#define CAPABILITY_CACHE_FILE_NAME "camera_capabilities.cache"
+#define CAPABILITY_CACHE_VERSION 1
+
+namespace {
+
+std::string GetPlatformBuild() {
+  char *value = nullptr;
+  int ret = system_info_get_platform_string(
+      "http://tizen.org/system/build.string", &value);
+  if (ret != SYSTEM_INFO_ERROR_NONE || !value) {
+    LOG_ERROR("Failed to get the build string: %s", get_error_message(ret));
+    return "";
+  }
+  std::string build(value);
+  free(value);
+  return build;
+}
+
+void WriteResolutions(std::ostream &out,
+                      const std::vector<std::pair<int, int>> &resolutions) {
+  out << resolutions.size();
+  for (const auto &resolution : resolutions) {
+    out << " " << resolution.first << " " << resolution.second;
+  }
+  out << "\n";
+}
+
+bool ReadResolutions(std::istream &in,
+                     std::vector<std::pair<int, int>> &resolutions) {
+  size_t count = 0;
+  if (!(in >> count)) {
+    return false;
+  }
+  resolutions.clear();
+  for (size_t i = 0; i < count; i++) {
+    int width = 0, height = 0;
+    if (!(in >> width >> height)) {
+      return false;
+    }
+    resolutions.emplace_back(width, height);
+  }
+  return true;
+}
+
+}  // namespace
+
+CameraCapabilityCache &CameraCapabilityCache::GetInstance() {
+  static CameraCapabilityCache instance;
+  return instance;
+}
+
+bool CameraCapabilityCache::GetCameraList(std::vector<int> &lens_orientations) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  if (lens_orientations_.empty()) {
+    return false;
+  }
+  lens_orientations = lens_orientations_;
+  return true;
+}
+
+void CameraCapabilityCache::SetCameraList(
+    const std::vector<int> &lens_orientations) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  lens_orientations_ = lens_orientations;
+  Save();
+}
+
+bool CameraCapabilityCache::GetCapabilities(int device,
+                                            CameraCapabilities &capabilities) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  auto iter = capabilities_.find(device);
+  if (iter == capabilities_.end()) {
+    return false;
+  }
+  capabilities = iter->second;
+  return true;
+}
+
+void CameraCapabilityCache::SetCapabilities(
+    int device, const CameraCapabilities &capabilities) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  capabilities_[device] = capabilities;
+  Save();
+}
+
+void CameraCapabilityCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  LoadIfNeeded();
+  lens_orientations_.clear();
+  capabilities_.clear();
+  if (!file_path_.empty()) {
+    remove(file_path_.c_str());
+  }
+}
+
+void CameraCapabilityCache::LoadIfNeeded() {
+  if (is_loaded_) {
+    return;
+  }
+  is_loaded_ = true;
+  build_ = GetPlatformBuild();
+
+  char *data_path = app_get_data_path();
+  if (!data_path) {
+    LOG_ERROR("app_get_data_path fail");
+    return;
+  }
+  file_path_ = std::string(data_path) + CAPABILITY_CACHE_FILE_NAME;
+  free(data_path);
+
+  std::ifstream file(file_path_);
+  if (!file.is_open()) {
+    return;
+  }
+  int version = 0;
+  std::string build;
+  file >> version;
+  file.ignore();
+  std::getline(file, build);
+  if (version != CAPABILITY_CACHE_VERSION || build.empty() ||
+      build != build_) {
+    LOG_INFO("Discard the capability cache of build[%s]", build.c_str());
+    return;
+  }
+
+  std::vector<int> lens_orientations;
+  std::map<int, CameraCapabilities> capabilities;
+  size_t count = 0;
+  if (!(file >> count)) {
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    int angle = 0;
+    if (!(file >> angle)) {
+      return;
+    }
+    lens_orientations.push_back(angle);
+  }
+  if (!(file >> count)) {
+    return;
+  }
+  for (size_t i = 0; i < count; i++) {
+    int device = 0;
+    CameraCapabilities entry;
+    if (!(file >> device >> entry.lens_orientation >>
+          entry.is_zoom_supported >> entry.zoom_min >> entry.zoom_max >>
+          entry.is_exposure_supported >> entry.exposure_min >>
+          entry.exposure_max) ||
+        !ReadResolutions(file, entry.capture_resolutions) ||
+        !ReadResolutions(file, entry.recorder_resolutions)) {
+      LOG_WARN("Corrupted capability cache");
+      return;
+    }
+    capabilities[device] = entry;
+  }
+  lens_orientations_ = std::move(lens_orientations);
+  capabilities_ = std::move(capabilities);
+}
+
+void CameraCapabilityCache::Save() {
+  if (file_path_.empty() || build_.empty()) {
+    return;
+  }
+  std::ostringstream out;
+  out << CAPABILITY_CACHE_VERSION << "\n" << build_ << "\n";
+  out << lens_orientations_.size();
+  for (int angle : lens_orientations_) {
+    out << " " << angle;
+  }
+  out << "\n" << capabilities_.size() << "\n";
+  for (const auto &iter : capabilities_) {
+    const CameraCapabilities &entry = iter.second;
+    out << iter.first << " " << entry.lens_orientation << " "
+        << entry.is_zoom_supported << " " << entry.zoom_min << " "
+        << entry.zoom_max << " " << entry.is_exposure_supported << " "
+        << entry.exposure_min << " " << entry.exposure_max << "\n";
+    WriteResolutions(out, entry.capture_resolutions);
+    WriteResolutions(out, entry.recorder_resolutions);
+  }
+
+  // Write to a temporary file first so that a crash never leaves a truncated
+  // cache behind.
+  std::string temp_path = file_path_ + ".tmp";
+  std::ofstream file(temp_path, std::ios::trunc);
+  if (!file.is_open()) {
+    LOG_ERROR("Failed to open %s", temp_path.c_str());
+    return;
+  }
+  file << out.str();
+  file.close();
+  if (file.fail() || rename(temp_path.c_str(), file_path_.c_str()) != 0) {
+    LOG_ERROR("Failed to write %s", file_path_.c_str());
+    remove(temp_path.c_str());
+  }
+}
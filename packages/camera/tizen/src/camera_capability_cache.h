@@ -0,0 +1,60 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_CAMERA_CAPABILITY_CACHE_H_
+#define FLUTTER_PLUGIN_CAMERA_CAPABILITY_CACHE_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct CameraCapabilities {
+  int lens_orientation{0};
+  std::vector<std::pair<int, int>> capture_resolutions;
+  std::vector<std::pair<int, int>> recorder_resolutions;
+  // The ranges are only valid if supported.
+  bool is_zoom_supported{false};
+  int zoom_min{0};
+  int zoom_max{0};
+  bool is_exposure_supported{false};
+  int exposure_min{0};
+  int exposure_max{0};
+};
+
+// Caches the capabilities of the camera devices in memory and in the app data
+// directory, so that opening a camera does not have to enumerate them through
+// the native API every time.
+//
+// The file is keyed by the platform build string and is ignored after a
+// firmware update.
+class CameraCapabilityCache {
+ public:
+  static CameraCapabilityCache &GetInstance();
+
+  // |lens_orientations| has one entry per camera device.
+  bool GetCameraList(std::vector<int> &lens_orientations);
+  void SetCameraList(const std::vector<int> &lens_orientations);
+
+  bool GetCapabilities(int device, CameraCapabilities &capabilities);
+  void SetCapabilities(int device, const CameraCapabilities &capabilities);
+
+  void Clear();
+
+ private:
+  CameraCapabilityCache() = default;
+
+  void LoadIfNeeded();
+  void Save();
+
+  std::mutex mutex_;
+  bool is_loaded_{false};
+  std::string build_;
+  std::string file_path_;
+  std::vector<int> lens_orientations_;
+  std::map<int, CameraCapabilities> capabilities_;
+};
+
+#endif
@@ -4,20 +4,31 @@
 
 #include "camera_device.h"
 
+#include <Ecore.h>
 #include <app_common.h>
 #include <flutter/encodable_value.h>
 #include <sys/time.h>
 
+#include <chrono>
 #include <cmath>
 
+#include "camera_capability_cache.h"
 #include "log.h"
 
 // These macros came from tizen camera_app
 #define VIDEO_ENCODE_BITRATE 40000000 /* bps */
 #define AUDIO_SOURCE_SAMPLERATE_AAC 44100
 
+#define BURST_STOP_TIMEOUT_MS 3000
+
 namespace {
 
+uint64_t MonotonicTimestampUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
 uint64_t Timestamp() {
   struct timeval tv;
   gettimeofday(&tv, nullptr);
@@ -40,13 +51,14 @@ std::string CreateTempFileName(const std::string &prefix,
   return file_name;
 }
 
-bool IsValidMediaPacket(media_packet_h media_packet) {
-  tbm_surface_h surface = nullptr;
-  int ret = media_packet_get_tbm_surface(media_packet, &surface);
-  if (ret != MEDIA_PACKET_ERROR_NONE) {
-    return false;
-  }
-  return true;
+void RunOnMainThread(std::function<void()> task) {
+  ecore_main_loop_thread_safe_call_async(
+      [](void *data) {
+        std::unique_ptr<std::function<void()>> task(
+            static_cast<std::function<void()> *>(data));
+        (*task)();
+      },
+      new std::function<void()>(std::move(task)));
 }
 
 ExifTagOrientation ChooseExifTagOrientatoin(OrientationType device_orientation,
@@ -232,20 +244,29 @@ bool FocusModeToString(FocusMode focus_mode, std::string &mode) {
 }
 
 flutter::EncodableValue CameraDevice::GetAvailableCameras() {
-  CameraDevice default_camera;
-  int count = 0;
-  default_camera.GetCameraDeviceCount(count);
+  std::vector<int> lens_orientations;
+  if (!CameraCapabilityCache::GetInstance().GetCameraList(lens_orientations)) {
+    CameraDevice default_camera;
+    int count = 0;
+    default_camera.GetCameraDeviceCount(count);
+    for (int i = 0; i < count; i++) {
+      int angle = 0;
+      default_camera.GetCameraLensOrientation(angle);
+      lens_orientations.push_back(angle);
+      default_camera.ChangeCameraDeviceType(CameraDeviceType::kFront);
+    }
+    if (!lens_orientations.empty()) {
+      CameraCapabilityCache::GetInstance().SetCameraList(lens_orientations);
+    }
+  }
 
   flutter::EncodableList cameras;
-  for (int i = 0; i < count; i++) {
+  for (size_t i = 0; i < lens_orientations.size(); i++) {
     flutter::EncodableMap camera;
     camera[flutter::EncodableValue("name")] =
         flutter::EncodableValue("camera" + std::to_string(i + 1));
-
-    int angle = 0;
-    default_camera.GetCameraLensOrientation(angle);
     camera[flutter::EncodableValue("sensorOrientation")] =
-        flutter::EncodableValue(angle);
+        flutter::EncodableValue(lens_orientations[i]);
     std::string lensFacing;
     if (i == 0) {
       lensFacing = "back";
@@ -256,7 +277,6 @@ flutter::EncodableValue CameraDevice::GetAvailableCameras() {
         flutter::EncodableValue(lensFacing);
 
     cameras.push_back(flutter::EncodableValue(camera));
-    default_camera.ChangeCameraDeviceType(CameraDeviceType::kFront);
   }
   return flutter::EncodableValue(cameras);
 }
@@ -269,8 +289,9 @@ CameraDevice::CameraDevice() {
 CameraDevice::CameraDevice(flutter::PluginRegistrar *registrar,
                            CameraDeviceType type,
                            ResolutionPreset resolution_preset,
-                           bool enable_audio)
+                           bool enable_audio, ImageStream *image_stream)
     : registrar_(registrar),
+      image_stream_(image_stream),
       type_(type),
       resolution_preset_(resolution_preset),
       enable_audio_(enable_audio) {
@@ -313,27 +334,30 @@ CameraDevice::CameraDevice(flutter::PluginRegistrar *registrar,
               current);
     auto self = (CameraDevice *)data;
     if (previous != current) {
+      self->metrics_->OnRecorderStateChanged();
       self->UpdateStates();
     }
   });
+  SetRecorderVideoEncodeDecisionCb([](media_packet_h frame, void *data) {
+    auto self = (CameraDevice *)data;
+    if (self->is_first_frame_pending_.exchange(false)) {
+      self->first_frame_latency_us_ =
+          MonotonicTimestampUs() - self->record_requested_us_;
+      LOG_DEBUG("First frame latency[%lld us]",
+                static_cast<long long>(self->first_frame_latency_us_));
+    }
+    return true;
+  });
 
-  // Gather supported resolutions
-  ForeachCameraSupportedCaptureResolutions(
-      [this](int supported_width, int supported_height) -> bool {
-        LOG_DEBUG("supported camera capture resolution width[%d] height[%d]",
-                  supported_width, supported_height);
-        std::pair<int, int> resolution = {supported_width, supported_height};
-        supported_camera_resolutions_.emplace_back(resolution);
-        return true;
-      });
-  ForeachRecorderSupprotedVideoResolutions(
-      [this](int supported_width, int supported_height) -> bool {
-        LOG_DEBUG("supported recorder video resolution width[%d] height[%d]",
-                  supported_width, supported_height);
-        std::pair<int, int> resolution = {supported_width, supported_height};
-        supported_recorder_resolutions_.emplace_back(resolution);
-        return true;
-      });
+  // Gather capabilities
+  if (!CameraCapabilityCache::GetInstance().GetCapabilities(
+          static_cast<int>(type_), capabilities_)) {
+    QueryCapabilities(capabilities_);
+    CameraCapabilityCache::GetInstance().SetCapabilities(
+        static_cast<int>(type_), capabilities_);
+  }
+  supported_camera_resolutions_ = capabilities_.capture_resolutions;
+  supported_recorder_resolutions_ = capabilities_.recorder_resolutions;
 
   SetResolutionPreset(resolution_preset_);
 
@@ -342,30 +366,20 @@ CameraDevice::CameraDevice(flutter::PluginRegistrar *registrar,
       std::make_unique<flutter::TextureVariant>(flutter::GpuBufferTexture(
           [this](size_t width,
                  size_t height) -> const FlutterDesktopGpuBuffer * {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (prepared_packet_ && !IsValidMediaPacket(prepared_packet_)) {
-              media_packet_destroy(prepared_packet_);
-              prepared_packet_ = nullptr;
-            }
-            if (current_packet_ && !IsValidMediaPacket(current_packet_)) {
-              media_packet_destroy(current_packet_);
-              current_packet_ = nullptr;
-            }
-            if (!prepared_packet_ && !current_packet_) {
-              return nullptr;
-            }
-            if (prepared_packet_ && !current_packet_) {
-              current_packet_ = prepared_packet_;
-              prepared_packet_ = nullptr;
-            }
-
+            // Only contended by Dispose(), after the texture is unregistered.
+            std::lock_guard<std::mutex> lock(current_packet_mutex_);
             tbm_surface_h surface = nullptr;
-            int ret = media_packet_get_tbm_surface(current_packet_, &surface);
-            if (ret != MEDIA_PACKET_ERROR_NONE) {
-              LOG_ERROR("media_packet_get_tbm_surface failed, error: %d", ret);
+            if (current_packet_ &&
+                media_packet_get_tbm_surface(current_packet_, &surface) !=
+                    MEDIA_PACKET_ERROR_NONE) {
               media_packet_destroy(current_packet_);
               current_packet_ = nullptr;
-              return nullptr;
+            }
+            if (!current_packet_) {
+              current_packet_ = preview_frame_ring_.Pop(&surface);
+              if (!current_packet_) {
+                return nullptr;
+              }
             }
             flutter_desktop_gpu_buffer_->buffer = surface;
             flutter_desktop_gpu_buffer_->width = width;
@@ -373,10 +387,19 @@ CameraDevice::CameraDevice(flutter::PluginRegistrar *registrar,
             return flutter_desktop_gpu_buffer_.get();
           },
           [this](void *buffer) -> void {
-            std::lock_guard<std::mutex> lock(mutex_);
-            if (current_packet_) {
-              media_packet_destroy(current_packet_);
-              current_packet_ = nullptr;
+            {
+              std::lock_guard<std::mutex> lock(current_packet_mutex_);
+              if (current_packet_) {
+                media_packet_destroy(current_packet_);
+                current_packet_ = nullptr;
+              }
+            }
+            // The notification of a frame pushed while this one was on screen
+            // may have been consumed by an obtain call that returned this
+            // packet again, so the engine may not ask for it anymore.
+            if (!preview_frame_ring_.IsEmpty()) {
+              registrar_->texture_registrar()->MarkTextureFrameAvailable(
+                  texture_id_);
             }
           }));
   texture_id_ =
@@ -388,10 +411,9 @@ CameraDevice::CameraDevice(flutter::PluginRegistrar *registrar,
       std::make_unique<CameraMethodChannel>(registrar_, texture_id_);
   device_method_channel_ = std::make_unique<DeviceMethodChannel>(registrar_);
 
-  int angle = 0;
-  GetCameraLensOrientation(angle);
   orientation_manager_ = std::make_unique<OrientationManager>(
-      device_method_channel_.get(), (OrientationType)angle,
+      device_method_channel_.get(),
+      (OrientationType)capabilities_.lens_orientation,
       type == CameraDeviceType::kFront);
 
   orientation_manager_->Start();
@@ -436,7 +458,39 @@ void CameraDevice::ChangeCameraDeviceType(CameraDeviceType type) {
 
 void CameraDevice::Dispose() {
   LOG_DEBUG("enter");
+  StopImageStream();
+  metrics_->Disable();
+  if (burst_state_) {
+    // Pending callbacks of the burst must not touch this device anymore.
+    burst_state_->device = nullptr;
+    // The camera must not deliver burst images after it is destroyed.
+    std::shared_ptr<BurstState> state = burst_state_;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (!state->is_capture_done) {
+      // The completion callback takes the lock, so it must not be held while
+      // stopping in case the callback is called synchronously.
+      lock.unlock();
+      bool is_stopped = StopCameraContinuousCapture();
+      lock.lock();
+      if (is_stopped &&
+          !state->capture_done.wait_for(
+              lock, std::chrono::milliseconds(BURST_STOP_TIMEOUT_MS),
+              [state] { return state->is_capture_done; })) {
+        LOG_ERROR("Timed out waiting for the burst capture to stop");
+      }
+    }
+    lock.unlock();
+    burst_state_ = nullptr;
+  }
+  if (prepare_recorder_idler_) {
+    ecore_idler_del(prepare_recorder_idler_);
+    prepare_recorder_idler_ = nullptr;
+  }
   if (recorder_) {
+    RecorderState state = RecorderState::kNone;
+    if (GetRecorderState(state) && state == RecorderState::kReady) {
+      UnprepareRecorder();
+    }
     DestroyRecorder();
   }
 
@@ -457,15 +511,18 @@ void CameraDevice::Dispose() {
     registrar_->texture_registrar()->UnregisterTexture(texture_id_);
   }
 
-  if (current_packet_) {
-    media_packet_destroy(current_packet_);
-    current_packet_ = nullptr;
+  // The preview callback is unset and the texture is unregistered, so no
+  // packet can be put or obtained anymore. The lock waits for a release
+  // callback that may still be running on the raster thread.
+  {
+    std::lock_guard<std::mutex> lock(current_packet_mutex_);
+    if (current_packet_) {
+      media_packet_destroy(current_packet_);
+      current_packet_ = nullptr;
+    }
   }
 
-  if (prepared_packet_) {
-    media_packet_destroy(prepared_packet_);
-    prepared_packet_ = nullptr;
-  }
+  preview_frame_ring_.Clear();
 }
 
 bool CameraDevice::ForeachCameraSupportedCaptureResolutions(
@@ -492,6 +549,30 @@ bool CameraDevice::GetCameraCaptureResolution(int &width, int &height) {
   return true;
 }
 
+void CameraDevice::QueryCapabilities(CameraCapabilities &capabilities) {
+  GetCameraLensOrientation(capabilities.lens_orientation);
+  ForeachCameraSupportedCaptureResolutions(
+      [&capabilities](int supported_width, int supported_height) -> bool {
+        LOG_DEBUG("supported camera capture resolution width[%d] height[%d]",
+                  supported_width, supported_height);
+        capabilities.capture_resolutions.emplace_back(supported_width,
+                                                      supported_height);
+        return true;
+      });
+  ForeachRecorderSupprotedVideoResolutions(
+      [&capabilities](int supported_width, int supported_height) -> bool {
+        LOG_DEBUG("supported recorder video resolution width[%d] height[%d]",
+                  supported_width, supported_height);
+        capabilities.recorder_resolutions.emplace_back(supported_width,
+                                                       supported_height);
+        return true;
+      });
+  capabilities.is_zoom_supported =
+      GetCameraZoomRange(capabilities.zoom_min, capabilities.zoom_max);
+  capabilities.is_exposure_supported = GetCameraExposureRange(
+      capabilities.exposure_min, capabilities.exposure_max);
+}
+
 bool CameraDevice::GetCameraDeviceCount(int &count) {
   // If the device supports primary and secondary camera, this returns 2. If 1
   // is returned, the device only supports primary camera.
@@ -903,6 +984,16 @@ bool CameraDevice::UnprepareRecorder() {
   return true;
 }
 
+bool CameraDevice::SetRecorderVideoEncodeDecisionCb(
+    RecorderVideoEncodeDecisionCb callback) {
+  int error = recorder_set_video_encode_decision_cb(recorder_, callback, this);
+  RETV_LOG_ERROR_IF(
+      error != RECORDER_ERROR_NONE, false,
+      "recorder_set_video_encode_decision_cb fail - error[%d]: %s", error,
+      get_error_message(error));
+  return true;
+}
+
 bool CameraDevice::UnsetRecorderRecordingLimitReachedCb() {
   int error = recorder_unset_recording_limit_reached_cb(recorder_);
   RETV_LOG_ERROR_IF(
@@ -941,35 +1032,31 @@ Size CameraDevice::GetRecommendedPreviewResolution() {
 }
 
 double CameraDevice::GetMaxExposureOffset() {
-  int min = 0, max = 0;
-  if (!GetCameraExposureRange(min, max)) {
+  if (!capabilities_.is_exposure_supported) {
     throw CameraDeviceError("Failed to get max exposure offset");
   }
-  return static_cast<double>(max);
+  return static_cast<double>(capabilities_.exposure_max);
 }
 
 double CameraDevice::GetMinExposureOffset() {
-  int min = 0, max = 0;
-  if (!GetCameraExposureRange(min, max)) {
+  if (!capabilities_.is_exposure_supported) {
     throw CameraDeviceError("Failed to get min exposure offset");
   }
-  return static_cast<double>(min);
+  return static_cast<double>(capabilities_.exposure_min);
 }
 
 double CameraDevice::GetMaxZoomLevel() {
-  int min = 0, max = 0;
-  if (!GetCameraZoomRange(min, max)) {
+  if (!capabilities_.is_zoom_supported) {
     throw CameraDeviceError("Failed to get max zoom level");
   }
-  return static_cast<double>(max);
+  return static_cast<double>(capabilities_.zoom_max);
 }
 
 double CameraDevice::GetMinZoomLevel() {
-  int min = 0, max = 0;
-  if (!GetCameraZoomRange(min, max)) {
+  if (!capabilities_.is_zoom_supported) {
     throw CameraDeviceError("Failed to get min zoom level");
   }
-  return static_cast<double>(min);
+  return static_cast<double>(capabilities_.zoom_min);
 }
 
 void CameraDevice::Open(
@@ -987,20 +1074,20 @@ void CameraDevice::Open(
 
   if (!SetCameraMediaPacketPreviewCb([](media_packet_h packet, void *data) {
         auto self = static_cast<CameraDevice *>(data);
-        std::lock_guard<std::mutex> lock(self->mutex_);
-        if (self->prepared_packet_) {
-          media_packet_destroy(self->prepared_packet_);
-          self->prepared_packet_ = packet;
-          return;
+        self->metrics_->OnPreviewFrame();
+        if (self->image_stream_ && self->image_stream_->IsActive()) {
+          self->image_stream_->OnPreviewPacket(packet);
         }
         if (self->is_preview_paused_) {
           media_packet_destroy(packet);
-          self->prepared_packet_ = nullptr;
           return;
         }
-        self->prepared_packet_ = packet;
-        self->registrar_->texture_registrar()->MarkTextureFrameAvailable(
-            self->texture_id_);
+        // Notify only when the ring was empty. The rest are picked up as the
+        // texture releases its buffers.
+        if (self->preview_frame_ring_.Push(packet)) {
+          self->registrar_->texture_registrar()->MarkTextureFrameAvailable(
+              self->texture_id_);
+        }
       })) {
     result->Error(kCameraDeviceError, "Failed to set media callback");
     return;
@@ -1010,6 +1097,7 @@ void CameraDevice::Open(
     result->Error(kCameraDeviceError, "Failed to start preview");
     return;
   }
+  SchedulePrepareRecorderInAdvance();
 
   SetCameraAutoFocusChangedCb([](camera_focus_state_e state, void *user_data) {
     LOG_DEBUG("Change auto focus state[%d]", static_cast<int>(state));
@@ -1066,6 +1154,7 @@ void CameraDevice::PauseVideoRecording(
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
         &&result) noexcept {
   LOG_DEBUG("enter");
+  metrics_->OnRecorderStateRequested();
   if (PauseRecorder()) {
     result->Success();
   } else {
@@ -1083,6 +1172,7 @@ void CameraDevice::ResumeVideoRecording(
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
         &&result) noexcept {
   LOG_DEBUG("enter");
+  metrics_->OnRecorderStateRequested();
   if (StartRecorder()) {
     result->Success();
   } else {
@@ -1202,6 +1292,7 @@ void CameraDevice::SetFocusPoint(double x, double y) {
 }
 
 void CameraDevice::SetResolutionPreset(ResolutionPreset resolution_preset) {
+  InvalidateRecorderPreparedInAdvance();
   std::pair<int, int> resolution{0, 0};
   LOG_DEBUG("ResolutionPreset[%d]", (int)resolution_preset);
   switch (resolution_preset) {
@@ -1264,11 +1355,85 @@ void CameraDevice::SetZoomLevel(double zoom_level) {
   }
 }
 
+void CameraDevice::PrepareForVideoRecording() {
+  LOG_DEBUG("enter");
+  is_recorder_preparation_enabled_ = true;
+  UpdateStates();
+  if (camera_state_ == CameraDeviceState::kPreview &&
+      !is_recorder_prepared_in_advance_) {
+    PrepareRecorderInAdvance();
+  }
+}
+
+void CameraDevice::PrepareRecorderInAdvance() {
+  RecorderState state = RecorderState::kNone;
+  if (!GetRecorderState(state) || state != RecorderState::kCreated) {
+    return;
+  }
+  // Same as StartVideoRecording(), but done while the user is not waiting.
+  StopCameraPreview();
+  if (PrepareRecorder()) {
+    is_recorder_prepared_in_advance_ = true;
+  } else {
+    StartCameraPreview();
+  }
+  UpdateStates();
+}
+
+void CameraDevice::SchedulePrepareRecorderInAdvance() {
+  if (is_recorder_preparation_enabled_ && !prepare_recorder_idler_) {
+    prepare_recorder_idler_ = ecore_idler_add(OnPrepareRecorderIdle, this);
+  }
+}
+
+void CameraDevice::InvalidateRecorderPreparedInAdvance() {
+  if (!is_recorder_prepared_in_advance_) {
+    return;
+  }
+  LOG_DEBUG("Recorder settings changed, prepare the recorder again");
+  is_recorder_prepared_in_advance_ = false;
+  UnprepareRecorder();
+  StartCameraPreview();
+  UpdateStates();
+  SchedulePrepareRecorderInAdvance();
+}
+
+Eina_Bool CameraDevice::OnPrepareRecorderIdle(void *data) {
+  auto self = static_cast<CameraDevice *>(data);
+  self->prepare_recorder_idler_ = nullptr;
+  if (!self->is_recorder_prepared_in_advance_) {
+    self->PrepareRecorderInAdvance();
+  }
+  return ECORE_CALLBACK_CANCEL;
+}
+
+flutter::EncodableMap CameraDevice::GetVideoRecordingStats() {
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("isRecorderPrepared")] =
+      flutter::EncodableValue(is_recorder_prepared_in_advance_);
+  map[flutter::EncodableValue("wasRecorderPrepared")] =
+      flutter::EncodableValue(was_recorder_prepared_in_advance_);
+  map[flutter::EncodableValue("startLatencyUs")] =
+      flutter::EncodableValue(record_start_latency_us_);
+  map[flutter::EncodableValue("firstFrameLatencyUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(first_frame_latency_us_));
+  return map;
+}
+
 void CameraDevice::StartVideoRecording(
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
         &&result) noexcept {
   LOG_DEBUG("enter");
-  StopCameraPreview();
+  metrics_->OnRecorderStateRequested();
+  record_requested_us_ = MonotonicTimestampUs();
+  record_start_latency_us_ = -1;
+  first_frame_latency_us_ = -1;
+  is_first_frame_pending_ = true;
+
+  was_recorder_prepared_in_advance_ = is_recorder_prepared_in_advance_;
+  if (!is_recorder_prepared_in_advance_) {
+    StopCameraPreview();
+  }
 
   std::string file_name = CreateTempFileName("REC", "mp4");
   SetRecorderFileName(file_name);
@@ -1276,11 +1441,16 @@ void CameraDevice::StartVideoRecording(
       is_orientation_locked_
           ? locked_orientation_
           : orientation_manager_->GetDeviceOrientationType()));
-  PrepareRecorder();
+  if (!is_recorder_prepared_in_advance_) {
+    PrepareRecorder();
+  }
+  is_recorder_prepared_in_advance_ = false;
 
   if (StartRecorder()) {
+    record_start_latency_us_ = MonotonicTimestampUs() - record_requested_us_;
     result->Success();
   } else {
+    is_first_frame_pending_ = false;
     result->Error(kCameraDeviceError, "Failed to start recorder");
   }
   UpdateStates();
@@ -1290,14 +1460,25 @@ void CameraDevice::StopVideoRecording(
     std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
         &&result) noexcept {
   LOG_DEBUG("enter");
+  metrics_->OnRecorderStateRequested();
   std::string file_name;
   int success = false;
   if (CommitRecorder() && GetRecorderFileName(file_name)) {
     success = true;
   }
-
-  UnprepareRecorder();
-  StartCameraPreview();
+  is_first_frame_pending_ = false;
+
+  if (is_recorder_preparation_enabled_) {
+    // The recorder stays ready and the preview keeps running for the next
+    // recording.
+    RecorderState state = RecorderState::kNone;
+    is_recorder_prepared_in_advance_ =
+        GetRecorderState(state) && state == RecorderState::kReady;
+  }
+  if (!is_recorder_prepared_in_advance_) {
+    UnprepareRecorder();
+    StartCameraPreview();
+  }
 
   if (success) {
     result->Success(flutter::EncodableValue(file_name));
@@ -1309,20 +1490,51 @@ void CameraDevice::StopVideoRecording(
 }
 
 void CameraDevice::TakePicture(
-    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
-        &&result) noexcept {
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> &&result,
+    bool in_memory) noexcept {
   SetCameraExifTagOrientatoin(ChooseExifTagOrientatoin(
       is_orientation_locked_ ? locked_orientation_
                              : orientation_manager_->GetDeviceOrientationType(),
       type_ == CameraDeviceType::kFront));
+  if (burst_state_) {
+    result->Error(kCameraDeviceError, "Burst capture is in progress");
+    return;
+  }
   auto p_result = result.release();
+  uint64_t requested_us = CameraMetrics::Now();
   if (!StartCameraCapture(
-          [p_result, this](const std::string &captured_file_path) {
-            flutter::EncodableValue value(captured_file_path);
-            p_result->Success(value);
+          [p_result, in_memory, requested_us,
+           this](std::vector<uint8_t> &&image) {
+            // Resume the preview before the image is persisted, so that the
+            // next capture is not delayed by the file system.
             StartCameraPreview();
             UpdateStates();
-            delete p_result;
+            if (in_memory) {
+              metrics_->OnCaptureCompleted(CameraMetrics::Now() - requested_us);
+              p_result->Success(flutter::EncodableValue(std::move(image)));
+              delete p_result;
+              return;
+            }
+            std::string file_name = CreateTempFileName("CAP", "jpg");
+            if (!file_name.size()) {
+              p_result->Error("Insufficient memory",
+                              "app_get_cache_path fail");
+              delete p_result;
+              return;
+            }
+            capture_writer_->Write(
+                file_name, std::move(image),
+                [p_result, requested_us, metrics = metrics_](
+                    const std::string &path, const std::string &error) {
+                  if (error.size()) {
+                    p_result->Error("Insufficient memory", error);
+                  } else {
+                    metrics->OnCaptureCompleted(CameraMetrics::Now() -
+                                                requested_us);
+                    p_result->Success(flutter::EncodableValue(path));
+                  }
+                  delete p_result;
+                });
           },
           [p_result](const std::string &code, const std::string &message) {
             p_result->Error(code, message);
@@ -1334,6 +1546,110 @@ void CameraDevice::TakePicture(
   UpdateStates();
 }
 
+void CameraDevice::StartBurstCapture(int count, int interval_ms) {
+  if (burst_state_) {
+    throw CameraDeviceError("Burst capture is already in progress");
+  }
+  bool is_supported = camera_is_supported_continuous_capture(camera_);
+  if (!is_supported) {
+    throw CameraDeviceError("Continuous capture is not supported");
+  }
+  SetCameraExifTagOrientatoin(ChooseExifTagOrientatoin(
+      is_orientation_locked_ ? locked_orientation_
+                             : orientation_manager_->GetDeviceOrientationType(),
+      type_ == CameraDeviceType::kFront));
+
+  auto state = std::make_shared<BurstState>();
+  state->device = this;
+  state->requested = count;
+  if (!StartCameraContinuousCapture(
+          count, interval_ms,
+          [writer = capture_writer_, state](std::vector<uint8_t> &&image) {
+            // Called on the camera thread while the burst goes on. The
+            // images are pipelined to the writer as they arrive.
+            int index = state->captured++;
+            std::string file_name = CreateTempFileName(
+                "BURST" + std::to_string(index) + "_", "jpg");
+            writer->Write(
+                file_name, std::move(image),
+                [state, index](const std::string &path,
+                               const std::string &error) {
+                  if (state->device) {
+                    state->device->OnBurstImageWritten(state, index, path,
+                                                       error);
+                  }
+                });
+          },
+          [state]() {
+            {
+              std::lock_guard<std::mutex> lock(state->mutex);
+              state->is_capture_done = true;
+            }
+            state->capture_done.notify_all();
+            RunOnMainThread([state]() {
+              if (state->device) {
+                state->device->StartCameraPreview();
+                state->device->UpdateStates();
+                state->device->MaybeCompleteBurst(state);
+              }
+            });
+          })) {
+    throw CameraDeviceError("Failed to start burst capture");
+  }
+  burst_state_ = state;
+  UpdateStates();
+}
+
+void CameraDevice::StopBurstCapture() {
+  if (burst_state_) {
+    StopCameraContinuousCapture();
+  }
+}
+
+void CameraDevice::OnBurstImageWritten(std::shared_ptr<BurstState> state,
+                                       int index, const std::string &path,
+                                       const std::string &error) {
+  if (error.size()) {
+    state->failed++;
+    LOG_ERROR("Failed to write a burst image: %s", error.c_str());
+  } else {
+    state->written++;
+    flutter::EncodableMap map;
+    map[flutter::EncodableValue("index")] =
+        flutter::EncodableValue(index);
+    map[flutter::EncodableValue("path")] = flutter::EncodableValue(path);
+    camera_method_channel_->Send(
+        CameraEventType::kBurstImageCaptured,
+        std::make_unique<flutter::EncodableValue>(map));
+  }
+  MaybeCompleteBurst(state);
+}
+
+void CameraDevice::MaybeCompleteBurst(std::shared_ptr<BurstState> state) {
+  // |captured| is final once the capture is done, and the writer reports
+  // every image on this thread, so both counts can be compared safely.
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->is_completion_sent || !state->is_capture_done ||
+        state->written + state->failed < state->captured) {
+      return;
+    }
+  }
+  state->is_completion_sent = true;
+  if (burst_state_ == state) {
+    burst_state_ = nullptr;
+  }
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("requested")] =
+      flutter::EncodableValue(state->requested);
+  map[flutter::EncodableValue("captured")] =
+      flutter::EncodableValue(state->written);
+  map[flutter::EncodableValue("failed")] =
+      flutter::EncodableValue(state->failed);
+  camera_method_channel_->Send(CameraEventType::kBurstCompleted,
+                               std::make_unique<flutter::EncodableValue>(map));
+}
+
 void CameraDevice::LockCaptureOrientation(OrientationType orientation) {
   locked_orientation_ =
       orientation_manager_->ConvertOrientation(orientation, false);
@@ -1347,6 +1663,53 @@ void CameraDevice::UnlockCaptureOrientation() {
   is_orientation_locked_ = false;
 }
 
+flutter::EncodableMap CameraDevice::GetPreviewFrameStats(bool reset) {
+  flutter::EncodableMap stats = preview_frame_ring_.StatsToEncodableMap();
+  if (reset) {
+    preview_frame_ring_.ResetStats();
+  }
+  return stats;
+}
+
+void CameraDevice::SetMetricsEnabled(bool enabled, int interval_ms) {
+  if (!enabled) {
+    metrics_->Disable();
+    return;
+  }
+  metrics_->Enable(interval_ms, [this](flutter::EncodableMap &&report) {
+    camera_method_channel_->Send(
+        CameraEventType::kMetrics,
+        std::make_unique<flutter::EncodableValue>(std::move(report)));
+  });
+}
+
+void CameraDevice::StartImageStream(const ImageStreamOptions &options) {
+  if (!image_stream_) {
+    throw CameraDeviceError("Image stream is not available");
+  }
+  if (options.analysis_width != 0 || options.analysis_height != 0) {
+    int width = 0, height = 0;
+    if (!GetCameraPreviewResolution(width, height)) {
+      throw CameraDeviceError("Failed to get preview resolution");
+    }
+    // Frames are only ever scaled down.
+    if (options.analysis_width <= 0 || options.analysis_width > width ||
+        options.analysis_height <= 0 || options.analysis_height > height) {
+      throw CameraDeviceError(
+          "InvalidArguments",
+          "The analysis size must be positive and at most the preview size " +
+              std::to_string(width) + "x" + std::to_string(height));
+    }
+  }
+  image_stream_->Start(options);
+}
+
+void CameraDevice::StopImageStream() {
+  if (image_stream_) {
+    image_stream_->Stop();
+  }
+}
+
 bool CameraDevice::SetCameraMediaPacketPreviewCb(
     CameraMediaPacketPreviewCb callback) {
   int error = camera_set_media_packet_preview_cb(camera_, callback, this);
@@ -1366,6 +1729,7 @@ bool CameraDevice::SetCameraPreviewCb(CameraPrivewCb callback) {
 }
 
 bool CameraDevice::SetCameraPreviewFormat(CameraPixelFormat format) {
+  InvalidateRecorderPreparedInAdvance();
   int error = camera_set_preview_format(camera_, (camera_pixel_format_e)format);
   RETV_LOG_ERROR_IF(error != CAMERA_ERROR_NONE, false,
                     "camera_set_preview_format fail - error[%d]: %s", error,
@@ -1379,6 +1743,7 @@ bool CameraDevice::SetCameraPreviewSize(Size size) {
   h = static_cast<int>(round(size.height));
 
   LOG_DEBUG("camera_set_preview_resolution w[%d] h[%d]", w, h);
+  InvalidateRecorderPreparedInAdvance();
 
   int error = camera_set_preview_resolution(camera_, w, h);
   RETV_LOG_ERROR_IF(error != CAMERA_ERROR_NONE, false,
@@ -1400,7 +1765,7 @@ bool CameraDevice::StartCameraCapture(const OnCaptureSuccessCb &on_success,
   struct Param {
     OnCaptureSuccessCb on_success;
     OnCaptureFailureCb on_failure;
-    std::string captured_file_path;
+    std::vector<uint8_t> image;
     std::string error;
     std::string error_message;
   };
@@ -1419,33 +1784,16 @@ bool CameraDevice::StartCameraCapture(const OnCaptureSuccessCb &on_success,
           p->error_message = "camera_start_capture fail";
           return;
         }
-
-        p->captured_file_path = CreateTempFileName("CAP", "jpg");
-        if (!p->captured_file_path.size()) {
-          p->error = "Insufficient memory";
-          p->error_message = "app_get_cache_path fail";
-          return;
-        }
-
-        FILE *file = fopen(p->captured_file_path.c_str(), "w+");
-        if (!file) {
-          p->error = "Insufficient memory";
-          p->error_message = "fopen fail";
-          return;
-        }
-
-        if (fwrite(image->data, 1, image->size, file) != image->size) {
-          p->error = "Insufficient memory";
-          p->error_message = "fwrite fail";
-        }
-        fclose(file);
+        // The image data is only valid during this callback. Copy it out and
+        // leave the file I/O to the capture writer.
+        p->image.assign(image->data, image->data + image->size);
       },
       [](void *user_data) {
         Param *p = (Param *)user_data;
         if (p->error.size()) {
           p->on_failure(p->error, p->error_message);
         } else {
-          p->on_success(p->captured_file_path);
+          p->on_success(std::move(p->image));
         }
         delete p;
       },
@@ -1461,6 +1809,47 @@ bool CameraDevice::StartCameraCapture(const OnCaptureSuccessCb &on_success,
   return true;
 }
 
+bool CameraDevice::StartCameraContinuousCapture(
+    int count, int interval_ms, const OnCaptureSuccessCb &on_image,
+    const OnContinuousCaptureCompletedCb &on_completed) {
+  struct Param {
+    OnCaptureSuccessCb on_image;
+    OnContinuousCaptureCompletedCb on_completed;
+  };
+
+  Param *p = new Param;  // Must delete on capture_completed_callback
+  p->on_image = on_image;
+  p->on_completed = on_completed;
+
+  int error = camera_start_continuous_capture(
+      camera_, count, interval_ms,
+      [](camera_image_data_s *image, camera_image_data_s *postview,
+         camera_image_data_s *thumbnail, void *user_data) {
+        Param *p = (Param *)user_data;
+        if (!image || !image->data) {
+          LOG_ERROR("Invalid image data");
+          return;
+        }
+        p->on_image(
+            std::vector<uint8_t>(image->data, image->data + image->size));
+      },
+      [](void *user_data) {
+        Param *p = (Param *)user_data;
+        p->on_completed();
+        delete p;
+      },
+      p);
+  LOG_ERROR_IF(error != CAMERA_ERROR_NONE,
+               "camera_start_continuous_capture fail - error[%d]: %s", error,
+               get_error_message(error));
+
+  if (error != CAMERA_ERROR_NONE) {
+    delete p;
+    return false;
+  }
+  return true;
+}
+
 bool CameraDevice::StartCameraAutoFocusing(bool continuous) {
   int error = camera_start_focusing(camera_, continuous);
   RETV_LOG_ERROR_IF(error != CAMERA_ERROR_NONE, false,
@@ -1495,6 +1884,14 @@ bool CameraDevice::StartCameraPreview() {
   return true;
 }
 
+bool CameraDevice::StopCameraContinuousCapture() {
+  int error = camera_stop_continuous_capture(camera_);
+  RETV_LOG_ERROR_IF(error != CAMERA_ERROR_NONE, false,
+                    "camera_stop_continuous_capture fail - error[%d]: %s",
+                    error, get_error_message(error));
+  return true;
+}
+
 bool CameraDevice::StopCameraAutoFocusing() {
   int error = camera_cancel_focusing(camera_);
   RETV_LOG_ERROR_IF(error != CAMERA_ERROR_NONE, false,
@@ -5,17 +5,26 @@
 #ifndef FLUTTER_PLUGIN_CAMERA_DEVICE_H_
 #define FLUTTER_PLUGIN_CAMERA_DEVICE_H_
 
+#include <Ecore.h>
 #include <camera.h>
 #include <flutter/encodable_value.h>
 #include <flutter/method_result.h>
 #include <flutter/plugin_registrar.h>
 #include <recorder.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 
+#include "camera_capability_cache.h"
 #include "camera_method_channel.h"
+#include "camera_metrics.h"
+#include "capture_writer.h"
 #include "device_method_channel.h"
+#include "image_stream.h"
 #include "orientation_manager.h"
+#include "preview_frame_ring.h"
 
 #define kCameraDeviceError "CameraDeviceError"
 
@@ -28,12 +37,13 @@ using CameraMediaPacketPreviewCb = camera_media_packet_preview_cb;
 using RecorderRecordingLimitReachedCb = recorder_recording_limit_reached_cb;
 using RecorderStateChangedCb = recorder_state_changed_cb;
 using RecorderStateChangedCb = recorder_state_changed_cb;
+using RecorderVideoEncodeDecisionCb = recorder_video_encode_decision_cb;
 
 using ForeachResolutionCb = std::function<bool(int width, int height)>;
-using OnCaptureSuccessCb =
-    std::function<void(const std::string &captured_file_path)>;
+using OnCaptureSuccessCb = std::function<void(std::vector<uint8_t> &&image)>;
 using OnCaptureFailureCb =
     std::function<void(const std::string &code, const std::string &message)>;
+using OnContinuousCaptureCompletedCb = std::function<void()>;
 
 enum class CameraDeviceType {
   kRear =
@@ -209,7 +219,8 @@ class CameraDevice {
 
   CameraDevice();
   CameraDevice(flutter::PluginRegistrar *registrar, CameraDeviceType typem,
-               ResolutionPreset resolution_preset, bool enable_audio);
+               ResolutionPreset resolution_preset, bool enable_audio,
+               ImageStream *image_stream);
   ~CameraDevice();
 
   void ChangeCameraDeviceType(CameraDeviceType type);
@@ -237,19 +248,50 @@ class CameraDevice {
   void SetFocusPoint(double x, double y);
   void SetResolutionPreset(ResolutionPreset resolution_preset);
   void SetZoomLevel(double zoom_level);
+  // Keeps the recorder prepared while the preview is running, so that
+  // StartVideoRecording() only has to call recorder_start(). Preparing the
+  // recorder requires the preview to be stopped, so the preview pauses once
+  // briefly, on the first idle after the preview starts or after a setting
+  // that the recorder depends on has changed.
+  void PrepareForVideoRecording();
+  flutter::EncodableMap GetVideoRecordingStats();
   void StartVideoRecording(
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
           &&result) noexcept;
   void StopVideoRecording(
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
           &&result) noexcept;
+  // If |in_memory| is true, the encoded image is returned as bytes instead of
+  // being written to a file.
   void TakePicture(
-      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>
-          &&result) noexcept;
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> &&result,
+      bool in_memory = false) noexcept;
+  // Captures |count| images |interval_ms| apart. Every written image is
+  // reported with a burstImageCaptured event, followed by a single
+  // burstCompleted event.
+  void StartBurstCapture(int count, int interval_ms);
+  void StopBurstCapture();
+  void SetCaptureFileSyncEnabled(bool enabled) {
+    capture_writer_->SetSyncEnabled(enabled);
+  }
 
   void LockCaptureOrientation(OrientationType orientation);
   void UnlockCaptureOrientation();
 
+  flutter::EncodableMap GetPreviewFrameStats(bool reset);
+  void SetPreviewFrameRingCapacity(size_t capacity) {
+    preview_frame_ring_.SetCapacity(capacity);
+  }
+  void SetPreviewFrameDropPolicy(PreviewFrameDropPolicy drop_policy) {
+    preview_frame_ring_.SetDropPolicy(drop_policy);
+  }
+
+  // Sends a metrics event every |interval_ms| while enabled.
+  void SetMetricsEnabled(bool enabled, int interval_ms);
+
+  void StartImageStream(const ImageStreamOptions &options);
+  void StopImageStream();
+
   void PausePreview() { is_preview_paused_ = true; }
   void ResumePreview() { is_preview_paused_ = false; }
 
@@ -266,6 +308,7 @@ class CameraDevice {
   bool GetCameraPreviewResolution(int &width, int &height);
   bool GetCameraState(CameraDeviceState &state);
   bool GetCameraZoomRange(int &min, int &max);
+  void QueryCapabilities(CameraCapabilities &capabilities);
   bool IsCameraSupportedCaptureResolution(std::pair<int, int> resolution);
   bool SetCameraFlashMode(CameraFlashMode mode);
   bool SetCameraFlip(CameraFlip flip);
@@ -286,9 +329,13 @@ class CameraDevice {
   bool SetCameraZoom(int zoom);
   bool StartCameraCapture(const OnCaptureSuccessCb &on_success,
                           const OnCaptureFailureCb &on_failure);
+  bool StartCameraContinuousCapture(
+      int count, int interval_ms, const OnCaptureSuccessCb &on_image,
+      const OnContinuousCaptureCompletedCb &on_completed);
   bool StartCameraAutoFocusing(bool continuous);
   bool StartCameraPreview();
   bool StopCameraAutoFocusing();
+  bool StopCameraContinuousCapture();
   bool StopCameraPreview();
   bool UnsetCameraMediaPacketPreviewCb();
   bool UnsetCameraAutoFocusChangedCb();
@@ -319,8 +366,15 @@ class CameraDevice {
 
   bool PauseRecorder();
   bool PrepareRecorder();
+  void PrepareRecorderInAdvance();
+  void SchedulePrepareRecorderInAdvance();
+  // Unprepares a recorder prepared in advance before a setting it depends on
+  // changes, and prepares it again on the next idle.
+  void InvalidateRecorderPreparedInAdvance();
+  static Eina_Bool OnPrepareRecorderIdle(void *data);
   bool StartRecorder();
   bool UnprepareRecorder();
+  bool SetRecorderVideoEncodeDecisionCb(RecorderVideoEncodeDecisionCb callback);
   bool UnsetRecorderRecordingLimitReachedCb();
   void UpdateStates();
 
@@ -328,14 +382,42 @@ class CameraDevice {
   flutter::PluginRegistrar *registrar_{nullptr};
   std::unique_ptr<flutter::TextureVariant> texture_variant_;
   std::unique_ptr<FlutterDesktopGpuBuffer> flutter_desktop_gpu_buffer_;
+  // The packet on screen. Accessed on the raster thread, and by Dispose()
+  // once the texture is unregistered.
   media_packet_h current_packet_{nullptr};
-  media_packet_h prepared_packet_{nullptr};
-
-  std::mutex mutex_;
+  std::mutex current_packet_mutex_;
+  PreviewFrameRing preview_frame_ring_;
 
   std::unique_ptr<CameraMethodChannel> camera_method_channel_;
   std::unique_ptr<DeviceMethodChannel> device_method_channel_;
   std::unique_ptr<OrientationManager> orientation_manager_;
+  ImageStream *image_stream_{nullptr};
+  // Shared with burst callbacks, which run on the camera thread.
+  std::shared_ptr<CaptureWriter> capture_writer_{
+      std::make_shared<CaptureWriter>()};
+  // Shared with capture callbacks that may outlive this device.
+  std::shared_ptr<CameraMetrics> metrics_{std::make_shared<CameraMetrics>()};
+
+  // Shared with the callbacks of an ongoing burst. Only accessed on the
+  // platform thread, except for |captured| and |is_capture_done|, which is
+  // guarded by |mutex|.
+  struct BurstState {
+    CameraDevice *device{nullptr};
+    int requested{0};
+    std::atomic<int> captured{0};
+    std::mutex mutex;
+    std::condition_variable capture_done;
+    bool is_capture_done{false};
+    int written{0};
+    int failed{0};
+    bool is_completion_sent{false};
+  };
+  // |index| is the position of the shot in the burst.
+  void OnBurstImageWritten(std::shared_ptr<BurstState> state, int index,
+                           const std::string &path, const std::string &error);
+  void MaybeCompleteBurst(std::shared_ptr<BurstState> state);
+
+  std::shared_ptr<BurstState> burst_state_;
 
   camera_h camera_{nullptr};
 
@@ -350,17 +432,27 @@ class CameraDevice {
 
   recorder_h recorder_{nullptr};
   RecorderState recorder_state_{RecorderState::kNone};
+  bool is_recorder_preparation_enabled_{false};
+  bool is_recorder_prepared_in_advance_{false};
+  Ecore_Idler *prepare_recorder_idler_{nullptr};
+  // Latencies of the last recording in microseconds, -1 if unknown.
+  uint64_t record_requested_us_{0};
+  int64_t record_start_latency_us_{-1};
+  std::atomic<bool> is_first_frame_pending_{false};
+  std::atomic<int64_t> first_frame_latency_us_{-1};
+  bool was_recorder_prepared_in_advance_{false};
 
   OrientationType locked_orientation_{OrientationType::kPortraitUp};
   bool is_orientation_locked_{false};
   int zoom_level_{0};
 
   ResolutionPreset resolution_preset_{ResolutionPreset::kLow};
+  CameraCapabilities capabilities_;
   std::vector<std::pair<int, int>> supported_camera_resolutions_;
   std::vector<std::pair<int, int>> supported_recorder_resolutions_;
 
   bool enable_audio_{true};
-  bool is_preview_paused_{false};
+  std::atomic<bool> is_preview_paused_{false};
 };
 
 #endif
@@ -20,6 +20,12 @@ std::string EventTypeToString(CameraEventType type) {
     return "cameraClosing";
   } else if (type == CameraEventType::kInitialized) {
     return "initialized";
+  } else if (type == CameraEventType::kBurstImageCaptured) {
+    return "burstImageCaptured";
+  } else if (type == CameraEventType::kBurstCompleted) {
+    return "burstCompleted";
+  } else if (type == CameraEventType::kMetrics) {
+    return "metrics";
   }
   LOG_WARN("Unknown event type!");
   return "unknown";
@@ -13,6 +13,9 @@ enum class CameraEventType {
   kError,
   kCameraClosing,
   kInitialized,
+  kBurstImageCaptured,
+  kBurstCompleted,
+  kMetrics,
 };
 
 class CameraMethodChannel {
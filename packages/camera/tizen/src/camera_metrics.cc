@@ -0,0 +1,172 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "camera_metrics.h"
+
+#include <algorithm>
+#include <chrono>
+
+// Bounds the memory used by a window if the report timer is starved.
+#define MAX_FRAME_INTERVALS 1024
+#define MAX_CAPTURE_LATENCIES 64
+
+namespace {
+
+template <typename T>
+T Percentile(std::vector<T> &values, int percent) {
+  if (values.empty()) {
+    return 0;
+  }
+  size_t index = (values.size() - 1) * percent / 100;
+  std::nth_element(values.begin(), values.begin() + index, values.end());
+  return values[index];
+}
+
+}  // namespace
+
+CameraMetrics::CameraMetrics() : frame_intervals_us_(MAX_FRAME_INTERVALS) {}
+
+CameraMetrics::~CameraMetrics() { Disable(); }
+
+uint64_t CameraMetrics::Now() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void CameraMetrics::Enable(int interval_ms, OnMetricsReportCb on_report) {
+  Disable();
+  window_start_us_ = Now();
+  last_frame_us_ = 0;
+  reported_frame_count_ = frame_count_;
+  reported_interval_count_ = interval_count_;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capture_latencies_us_.clear();
+    recorder_requested_us_ = 0;
+    recorder_state_latency_us_ = -1;
+  }
+  on_report_ = std::move(on_report);
+  timer_ = ecore_timer_add(interval_ms / 1000.0, OnReportTimer, this);
+  is_enabled_ = true;
+}
+
+void CameraMetrics::Disable() {
+  is_enabled_ = false;
+  if (timer_) {
+    ecore_timer_del(timer_);
+    timer_ = nullptr;
+  }
+  on_report_ = nullptr;
+}
+
+void CameraMetrics::OnPreviewFrame() {
+  if (!is_enabled_) {
+    return;
+  }
+  uint64_t now = Now();
+  uint64_t last_frame_us = last_frame_us_.exchange(now);
+  if (last_frame_us != 0) {
+    uint64_t index = interval_count_.load(std::memory_order_relaxed);
+    frame_intervals_us_[index % MAX_FRAME_INTERVALS].store(
+        static_cast<uint32_t>(now - last_frame_us), std::memory_order_relaxed);
+    interval_count_.store(index + 1, std::memory_order_release);
+  }
+  frame_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void CameraMetrics::OnCaptureCompleted(uint64_t latency_us) {
+  if (!is_enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capture_latencies_us_.size() < MAX_CAPTURE_LATENCIES) {
+    capture_latencies_us_.push_back(latency_us);
+  }
+}
+
+void CameraMetrics::OnRecorderStateRequested() {
+  if (!is_enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  recorder_requested_us_ = Now();
+}
+
+void CameraMetrics::OnRecorderStateChanged() {
+  if (!is_enabled_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (recorder_requested_us_ != 0) {
+    recorder_state_latency_us_ = Now() - recorder_requested_us_;
+    recorder_requested_us_ = 0;
+  }
+}
+
+Eina_Bool CameraMetrics::OnReportTimer(void *data) {
+  auto self = static_cast<CameraMetrics *>(data);
+  if (self->on_report_) {
+    self->on_report_(self->TakeReport());
+  }
+  return ECORE_CALLBACK_RENEW;
+}
+
+flutter::EncodableMap CameraMetrics::TakeReport() {
+  uint64_t now = Now();
+  uint64_t elapsed_us = now - window_start_us_;
+  uint64_t frame_count = frame_count_.load(std::memory_order_relaxed);
+  uint64_t frames = frame_count - reported_frame_count_;
+  double fps = elapsed_us ? frames * 1000000.0 / elapsed_us : 0;
+
+  // Only the newest intervals are still in the ring if the report timer was
+  // starved.
+  uint64_t interval_count = interval_count_.load(std::memory_order_acquire);
+  uint64_t first = std::max(reported_interval_count_,
+                            interval_count > MAX_FRAME_INTERVALS
+                                ? interval_count - MAX_FRAME_INTERVALS
+                                : 0);
+  std::vector<uint32_t> frame_intervals_us;
+  frame_intervals_us.reserve(interval_count - first);
+  for (uint64_t i = first; i < interval_count; i++) {
+    frame_intervals_us.push_back(frame_intervals_us_[i % MAX_FRAME_INTERVALS]
+                                     .load(std::memory_order_relaxed));
+  }
+
+  std::vector<uint64_t> capture_latencies_us;
+  int64_t recorder_state_latency_us;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capture_latencies_us.swap(capture_latencies_us_);
+    recorder_state_latency_us = recorder_state_latency_us_;
+    recorder_state_latency_us_ = -1;
+  }
+
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("fps")] = flutter::EncodableValue(fps);
+  map[flutter::EncodableValue("frames")] =
+      flutter::EncodableValue(static_cast<int64_t>(frames));
+  map[flutter::EncodableValue("frameIntervalP95Us")] = flutter::EncodableValue(
+      static_cast<int64_t>(Percentile(frame_intervals_us, 95)));
+  map[flutter::EncodableValue("frameIntervalMaxUs")] = flutter::EncodableValue(
+      static_cast<int64_t>(Percentile(frame_intervals_us, 100)));
+  if (!capture_latencies_us.empty()) {
+    flutter::EncodableList latencies;
+    for (uint64_t latency : capture_latencies_us) {
+      latencies.push_back(
+          flutter::EncodableValue(static_cast<int64_t>(latency)));
+    }
+    map[flutter::EncodableValue("captureLatenciesUs")] =
+        flutter::EncodableValue(latencies);
+  }
+  if (recorder_state_latency_us >= 0) {
+    map[flutter::EncodableValue("recorderStateLatencyUs")] =
+        flutter::EncodableValue(recorder_state_latency_us);
+  }
+
+  window_start_us_ = now;
+  reported_frame_count_ = frame_count;
+  reported_interval_count_ = interval_count;
+  return map;
+}
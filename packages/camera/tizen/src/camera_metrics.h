@@ -0,0 +1,66 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_CAMERA_METRICS_H_
+#define FLUTTER_PLUGIN_CAMERA_METRICS_H_
+
+#include <Ecore.h>
+#include <flutter/encodable_value.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+using OnMetricsReportCb = std::function<void(flutter::EncodableMap &&)>;
+
+// Collects preview and capture timings and reports them periodically while
+// enabled. All On*() methods may be called from any thread; they return
+// immediately while disabled. OnPreviewFrame() must only be called from a
+// single thread and never blocks.
+class CameraMetrics {
+ public:
+  CameraMetrics();
+  ~CameraMetrics();
+
+  // Reports every |interval_ms| on the main loop through |on_report|.
+  void Enable(int interval_ms, OnMetricsReportCb on_report);
+  void Disable();
+  bool IsEnabled() { return is_enabled_; }
+
+  void OnPreviewFrame();
+  void OnCaptureCompleted(uint64_t latency_us);
+  void OnRecorderStateRequested();
+  void OnRecorderStateChanged();
+
+  static uint64_t Now();
+
+ private:
+  static Eina_Bool OnReportTimer(void *data);
+  flutter::EncodableMap TakeReport();
+
+  std::atomic<bool> is_enabled_{false};
+  Ecore_Timer *timer_{nullptr};
+  OnMetricsReportCb on_report_;
+
+  // Written by OnPreviewFrame() only. |frame_intervals_us_| is a ring
+  // indexed by |interval_count_|, which only ever grows.
+  std::atomic<uint64_t> last_frame_us_{0};
+  std::atomic<uint64_t> frame_count_{0};
+  std::atomic<uint64_t> interval_count_{0};
+  std::vector<std::atomic<uint32_t>> frame_intervals_us_;
+
+  // Only accessed on the main loop.
+  uint64_t window_start_us_{0};
+  uint64_t reported_frame_count_{0};
+  uint64_t reported_interval_count_{0};
+
+  std::mutex mutex_;
+  std::vector<uint64_t> capture_latencies_us_;
+  uint64_t recorder_requested_us_{0};
+  int64_t recorder_state_latency_us_{-1};
+};
+
+#endif
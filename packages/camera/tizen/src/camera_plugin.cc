@@ -14,11 +14,11 @@
 #include <string>
 
 #include "camera_device.h"
+#include "image_stream.h"
 #include "log.h"
 #include "permission_manager.h"
 
 #define CAMERA_CHANNEL_NAME "plugins.flutter.io/camera"
-#define IMAGE_STREAM_CHANNEL_NAME "plugins.flutter.io/camera/imageStream"
 
 template <typename T>
 bool GetValueFromEncodableMap(flutter::EncodableMap &map, std::string key,
@@ -51,7 +51,9 @@ class CameraPlugin : public flutter::Plugin {
     registrar->AddPlugin(std::move(camera_plugin));
   }
 
-  CameraPlugin(flutter::PluginRegistrar *registrar) : registrar_(registrar) {}
+  CameraPlugin(flutter::PluginRegistrar *registrar)
+      : registrar_(registrar),
+        image_stream_(std::make_unique<ImageStream>(registrar)) {}
 
   virtual ~CameraPlugin() {}
 
@@ -127,8 +129,49 @@ class CameraPlugin : public flutter::Plugin {
       result->Error("InvalidArguments", "Please check 'imageFormatGroup'");
     } else if (method_name == "takePicture") {
       camera_->TakePicture(std::move(result));
+    } else if (method_name == "takePictureBytes") {
+      camera_->TakePicture(std::move(result), true);
+    } else if (method_name == "startBurstCapture") {
+      if (method_call.arguments()) {
+        flutter::EncodableMap arguments =
+            std::get<flutter::EncodableMap>(*method_call.arguments());
+        int count = 0;
+        int interval_ms = 0;
+        if (GetValueFromEncodableMap(arguments, "count", count) &&
+            GetValueFromEncodableMap(arguments, "intervalMs", interval_ms) &&
+            count > 0 && interval_ms >= 0) {
+          try {
+            camera_->StartBurstCapture(count, interval_ms);
+            result->Success();
+          } catch (const CameraDeviceError &error) {
+            result->Error(error.GetErrorCode(), error.GetErrorMessage());
+          }
+          return;
+        }
+      }
+      result->Error("InvalidArguments",
+                    "Please check 'count' and 'intervalMs'");
+    } else if (method_name == "stopBurstCapture") {
+      camera_->StopBurstCapture();
+      result->Success();
+    } else if (method_name == "setCaptureFileSync") {
+      if (method_call.arguments()) {
+        flutter::EncodableMap arguments =
+            std::get<flutter::EncodableMap>(*method_call.arguments());
+        bool enabled = false;
+        if (GetValueFromEncodableMap(arguments, "enabled", enabled)) {
+          camera_->SetCaptureFileSyncEnabled(enabled);
+          result->Success();
+          return;
+        }
+      }
+      result->Error("InvalidArguments", "Please check 'enabled'");
     } else if (method_name == "prepareForVideoRecording") {
-      result->NotImplemented();
+      camera_->PrepareForVideoRecording();
+      result->Success();
+    } else if (method_name == "getVideoRecordingStats") {
+      result->Success(
+          flutter::EncodableValue(camera_->GetVideoRecordingStats()));
     } else if (method_name == "startVideoRecording") {
       camera_->StartVideoRecording(std::move(result));
     } else if (method_name == "stopVideoRecording") {
@@ -251,9 +294,34 @@ class CameraPlugin : public flutter::Plugin {
       }
       result->Error("InvalidArguments", "Please check arguments(reset or x,y");
     } else if (method_name == "startImageStream") {
-      result->NotImplemented();
+      ImageStreamOptions options;
+      if (method_call.arguments() &&
+          std::holds_alternative<flutter::EncodableMap>(
+              *method_call.arguments())) {
+        flutter::EncodableMap arguments =
+            std::get<flutter::EncodableMap>(*method_call.arguments());
+        GetValueFromEncodableMap(arguments, "maxFps", options.max_fps);
+        GetValueFromEncodableMap(arguments, "maxWidth", options.max_width);
+        GetValueFromEncodableMap(arguments, "maxHeight", options.max_height);
+        GetValueFromEncodableMap(arguments, "analysisWidth",
+                                 options.analysis_width);
+        GetValueFromEncodableMap(arguments, "analysisHeight",
+                                 options.analysis_height);
+        std::string format;
+        if (GetValueFromEncodableMap(arguments, "format", format) &&
+            format == "rgba") {
+          options.format = ImageStreamFormat::kRgba;
+        }
+      }
+      try {
+        camera_->StartImageStream(options);
+        result->Success();
+      } catch (const CameraDeviceError &error) {
+        result->Error(error.GetErrorCode(), error.GetErrorMessage());
+      }
     } else if (method_name == "stopImageStream") {
-      result->NotImplemented();
+      camera_->StopImageStream();
+      result->Success();
     } else if (method_name == "getMaxZoomLevel") {
       try {
         float max = camera_->GetMaxZoomLevel();
@@ -307,6 +375,55 @@ class CameraPlugin : public flutter::Plugin {
     } else if (method_name == "resumePreview") {
       camera_->ResumePreview();
       result->Success();
+    } else if (method_name == "setMetricsEnabled") {
+      if (method_call.arguments()) {
+        flutter::EncodableMap arguments =
+            std::get<flutter::EncodableMap>(*method_call.arguments());
+        bool enabled = false;
+        int interval_ms = 1000;
+        GetValueFromEncodableMap(arguments, "intervalMs", interval_ms);
+        if (GetValueFromEncodableMap(arguments, "enabled", enabled) &&
+            interval_ms > 0) {
+          camera_->SetMetricsEnabled(enabled, interval_ms);
+          result->Success();
+          return;
+        }
+      }
+      result->Error("InvalidArguments", "Please check 'enabled'");
+    } else if (method_name == "getPreviewFrameStats") {
+      bool reset = false;
+      if (method_call.arguments() &&
+          std::holds_alternative<flutter::EncodableMap>(
+              *method_call.arguments())) {
+        flutter::EncodableMap arguments =
+            std::get<flutter::EncodableMap>(*method_call.arguments());
+        GetValueFromEncodableMap(arguments, "reset", reset);
+      }
+      result->Success(
+          flutter::EncodableValue(camera_->GetPreviewFrameStats(reset)));
+    } else if (method_name == "setPreviewFrameBufferCount") {
+      if (method_call.arguments()) {
+        flutter::EncodableMap arguments =
+            std::get<flutter::EncodableMap>(*method_call.arguments());
+        int count = 0;
+        std::string drop_policy;
+        if (GetValueFromEncodableMap(arguments, "dropPolicy", drop_policy) &&
+            drop_policy != "oldest" && drop_policy != "newest") {
+          result->Error("InvalidArguments", "Please check 'dropPolicy'");
+          return;
+        }
+        if (GetValueFromEncodableMap(arguments, "count", count) && count > 0) {
+          camera_->SetPreviewFrameRingCapacity(count);
+          if (!drop_policy.empty()) {
+            camera_->SetPreviewFrameDropPolicy(
+                drop_policy == "newest" ? PreviewFrameDropPolicy::kDropNewest
+                                        : PreviewFrameDropPolicy::kDropOldest);
+          }
+          result->Success();
+          return;
+        }
+      }
+      result->Error("InvalidArguments", "Please check 'count'");
     } else if (method_name == "dispose") {
       if (camera_) {
         camera_->Dispose();
@@ -334,8 +451,8 @@ class CameraPlugin : public flutter::Plugin {
     ResolutionPreset resolution_preset = ResolutionPreset::kLow;
     StringToResolutionPreset(preset, resolution_preset);
 
-    camera_ = std::make_unique<CameraDevice>(registrar_, type,
-                                             resolution_preset, enable_audio);
+    camera_ = std::make_unique<CameraDevice>(
+        registrar_, type, resolution_preset, enable_audio, image_stream_.get());
 
     flutter::EncodableMap ret;
     ret[flutter::EncodableValue("cameraId")] =
@@ -344,6 +461,8 @@ class CameraPlugin : public flutter::Plugin {
   }
 
   flutter::PluginRegistrar *registrar_{nullptr};
+  // Declared before |camera_| so that it outlives the camera device.
+  std::unique_ptr<ImageStream> image_stream_;
   std::unique_ptr<CameraDevice> camera_;
   PermissionManager pmm_;
 };
@@ -0,0 +1,87 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "capture_writer.h"
+
+#include <Ecore.h>
+#include <unistd.h>
+
+#include <cstdio>
+
+#include "log.h"
+
+CaptureWriter::~CaptureWriter() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  condition_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void CaptureWriter::Write(const std::string &path, std::vector<uint8_t> &&data,
+                          OnCaptureWrittenCb on_written) {
+  auto job = std::make_unique<Job>();
+  job->path = path;
+  job->data = std::move(data);
+  job->on_written = std::move(on_written);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+    // Started lazily, since most camera sessions never take a picture.
+    if (!thread_.joinable()) {
+      thread_ = std::thread(&CaptureWriter::Run, this);
+    }
+  }
+  condition_.notify_one();
+}
+
+void CaptureWriter::Run() {
+  while (true) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_.wait(lock, [this] { return is_stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      job = std::move(jobs_.front());
+      jobs_.pop_front();
+    }
+    job->error = WriteFile(*job);
+    job->data.clear();
+    job->data.shrink_to_fit();
+    ecore_main_loop_thread_safe_call_async(NotifyWritten, job.release());
+  }
+}
+
+std::string CaptureWriter::WriteFile(const Job &job) {
+  FILE *file = fopen(job.path.c_str(), "w+");
+  if (!file) {
+    LOG_ERROR("fopen fail - path[%s]", job.path.c_str());
+    return "fopen fail";
+  }
+  std::string error;
+  if (fwrite(job.data.data(), 1, job.data.size(), file) != job.data.size()) {
+    error = "fwrite fail";
+  } else if (is_sync_enabled_ &&
+             (fflush(file) != 0 || fsync(fileno(file)) != 0)) {
+    error = "fsync fail";
+  }
+  if (fclose(file) != 0 && error.empty()) {
+    error = "fclose fail";
+  }
+  if (!error.empty()) {
+    LOG_ERROR("%s - path[%s]", error.c_str(), job.path.c_str());
+    remove(job.path.c_str());
+  }
+  return error;
+}
+
+void CaptureWriter::NotifyWritten(void *data) {
+  std::unique_ptr<Job> job(static_cast<Job *>(data));
+  job->on_written(job->path, job->error);
+}
@@ -0,0 +1,61 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_CAPTURE_WRITER_H_
+#define FLUTTER_PLUGIN_CAPTURE_WRITER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// |error| is empty on success.
+using OnCaptureWrittenCb =
+    std::function<void(const std::string &path, const std::string &error)>;
+
+// Writes captured images to files on a dedicated I/O thread, so that the
+// camera callback thread is never blocked by the file system.
+//
+// Completion callbacks are invoked on the platform (main loop) thread in the
+// order the writes were requested.
+class CaptureWriter {
+ public:
+  CaptureWriter() = default;
+  // Waits until all pending writes are finished.
+  ~CaptureWriter();
+
+  // If enabled, every file is fsync()ed before its completion is reported.
+  void SetSyncEnabled(bool enabled) { is_sync_enabled_ = enabled; }
+  bool IsSyncEnabled() { return is_sync_enabled_; }
+
+  void Write(const std::string &path, std::vector<uint8_t> &&data,
+             OnCaptureWrittenCb on_written);
+
+ private:
+  struct Job {
+    std::string path;
+    std::vector<uint8_t> data;
+    OnCaptureWrittenCb on_written;
+    std::string error;
+  };
+
+  void Run();
+  std::string WriteFile(const Job &job);
+  static void NotifyWritten(void *data);
+
+  std::thread thread_;
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<std::unique_ptr<Job>> jobs_;
+  bool is_stopping_{false};
+  std::atomic<bool> is_sync_enabled_{false};
+};
+
+#endif
@@ -0,0 +1,271 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "color_convert.h"
+
+// COLOR_CONVERT_DISABLE_SIMD forces the scalar path, e.g. to test it on a
+// host that supports SIMD.
+#if defined(COLOR_CONVERT_DISABLE_SIMD)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define COLOR_CONVERT_NEON
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define COLOR_CONVERT_SSE2
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// BT.601 limited range coefficients scaled by 64. With these, every
+// intermediate value fits in 16 bits, or saturates only where the result is
+// clamped to 255 anyway, so the SIMD paths can stay in int16 lanes.
+#define COEFF_Y 74
+#define COEFF_RV 102
+#define COEFF_GU 25
+#define COEFF_GV 52
+#define COEFF_BU 129
+#define COEFF_ROUND 32
+#define COEFF_SHIFT 6
+
+namespace {
+
+inline uint8_t Clamp(int value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+inline void YuvToRgba(int y, int u, int v, uint8_t *rgba) {
+  int c = COEFF_Y * (y - 16) + COEFF_ROUND;
+  int d = u - 128;
+  int e = v - 128;
+  rgba[0] = Clamp((c + COEFF_RV * e) >> COEFF_SHIFT);
+  rgba[1] = Clamp((c - COEFF_GU * d - COEFF_GV * e) >> COEFF_SHIFT);
+  rgba[2] = Clamp((c + COEFF_BU * d) >> COEFF_SHIFT);
+  rgba[3] = 255;
+}
+
+// Converts |count| pixels of a row, starting at pixel |x|.
+void ConvertRowScalar(const Yuv420Frame &src, int row, int x, int count,
+                      int step, uint8_t *dst) {
+  const uint8_t *y_row = src.y + row * src.y_stride;
+  int chroma_offset = (row / 2) * src.chroma_stride;
+  for (int i = 0; i < count; i++, x++) {
+    int sx = x * step;
+    int chroma = chroma_offset + (sx / 2) * src.chroma_pixel_stride;
+    YuvToRgba(y_row[sx], src.u[chroma], src.v[chroma], dst + i * 4);
+  }
+}
+
+#if defined(COLOR_CONVERT_NEON)
+
+#define ROW_BLOCK 16
+
+// Converts 16 pixels of a row.
+void ConvertBlock(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                  int chroma_pixel_stride, uint8_t *dst) {
+  uint8x16_t y16 = vld1q_u8(y);
+  uint8x8_t u8, v8;
+  if (chroma_pixel_stride == 2) {
+    // |u| and |v| are one byte apart in the interleaved plane.
+    uint8x8x2_t uv = vld2_u8(u < v ? u : v);
+    u8 = u < v ? uv.val[0] : uv.val[1];
+    v8 = u < v ? uv.val[1] : uv.val[0];
+  } else {
+    u8 = vld1_u8(u);
+    v8 = vld1_u8(v);
+  }
+  uint8x8x2_t u_dup = vzip_u8(u8, u8);
+  uint8x8x2_t v_dup = vzip_u8(v8, v8);
+
+  const int16x8_t y_offset = vdupq_n_s16(16);
+  const int16x8_t uv_offset = vdupq_n_s16(128);
+  const int16x8_t round = vdupq_n_s16(COEFF_ROUND);
+  for (int half = 0; half < 2; half++) {
+    uint8x8_t y8 = half == 0 ? vget_low_u8(y16) : vget_high_u8(y16);
+    int16x8_t c = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(y8)), y_offset);
+    int16x8_t d = vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(u_dup.val[half])), uv_offset);
+    int16x8_t e = vsubq_s16(
+        vreinterpretq_s16_u16(vmovl_u8(v_dup.val[half])), uv_offset);
+    c = vaddq_s16(vmulq_n_s16(c, COEFF_Y), round);
+
+    int16x8_t r = vqaddq_s16(c, vmulq_n_s16(e, COEFF_RV));
+    int16x8_t g = vqsubq_s16(
+        vqsubq_s16(c, vmulq_n_s16(d, COEFF_GU)), vmulq_n_s16(e, COEFF_GV));
+    int16x8_t b = vqaddq_s16(c, vmulq_n_s16(d, COEFF_BU));
+
+    uint8x8x4_t rgba;
+    rgba.val[0] = vqmovun_s16(vshrq_n_s16(r, COEFF_SHIFT));
+    rgba.val[1] = vqmovun_s16(vshrq_n_s16(g, COEFF_SHIFT));
+    rgba.val[2] = vqmovun_s16(vshrq_n_s16(b, COEFF_SHIFT));
+    rgba.val[3] = vdup_n_u8(255);
+    vst4_u8(dst + half * 32, rgba);
+  }
+}
+
+#elif defined(COLOR_CONVERT_SSE2)
+
+#define ROW_BLOCK 8
+
+// Loads 4 chroma samples and duplicates each of them into two int16 lanes.
+inline __m128i LoadChroma(const uint8_t *p, int pixel_stride) {
+  __m128i zero = _mm_setzero_si128();
+  __m128i samples;
+  if (pixel_stride == 2) {
+    // Seven bytes cover four samples of either component, so the last byte
+    // of the interleaved plane is never read past.
+    uint8_t bytes[8] = {0};
+    memcpy(bytes, p, 7);
+    samples = _mm_and_si128(
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(bytes)),
+        _mm_set1_epi16(0xFF));
+  } else {
+    int32_t bytes;
+    memcpy(&bytes, p, 4);
+    samples = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+  }
+  return _mm_unpacklo_epi16(samples, samples);
+}
+
+// Converts 8 pixels of a row.
+void ConvertBlock(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                  int chroma_pixel_stride, uint8_t *dst) {
+  __m128i zero = _mm_setzero_si128();
+  __m128i c = _mm_unpacklo_epi8(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(y)), zero);
+  __m128i d = LoadChroma(u, chroma_pixel_stride);
+  __m128i e = LoadChroma(v, chroma_pixel_stride);
+  c = _mm_sub_epi16(c, _mm_set1_epi16(16));
+  d = _mm_sub_epi16(d, _mm_set1_epi16(128));
+  e = _mm_sub_epi16(e, _mm_set1_epi16(128));
+  c = _mm_add_epi16(_mm_mullo_epi16(c, _mm_set1_epi16(COEFF_Y)),
+                    _mm_set1_epi16(COEFF_ROUND));
+
+  __m128i r =
+      _mm_adds_epi16(c, _mm_mullo_epi16(e, _mm_set1_epi16(COEFF_RV)));
+  __m128i g = _mm_subs_epi16(
+      _mm_subs_epi16(c, _mm_mullo_epi16(d, _mm_set1_epi16(COEFF_GU))),
+      _mm_mullo_epi16(e, _mm_set1_epi16(COEFF_GV)));
+  __m128i b =
+      _mm_adds_epi16(c, _mm_mullo_epi16(d, _mm_set1_epi16(COEFF_BU)));
+
+  __m128i r8 = _mm_packus_epi16(_mm_srai_epi16(r, COEFF_SHIFT), zero);
+  __m128i g8 = _mm_packus_epi16(_mm_srai_epi16(g, COEFF_SHIFT), zero);
+  __m128i b8 = _mm_packus_epi16(_mm_srai_epi16(b, COEFF_SHIFT), zero);
+  __m128i a8 = _mm_set1_epi8(static_cast<char>(0xFF));
+  __m128i rg = _mm_unpacklo_epi8(r8, g8);
+  __m128i ba = _mm_unpacklo_epi8(b8, a8);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                   _mm_unpacklo_epi16(rg, ba));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 16),
+                   _mm_unpackhi_epi16(rg, ba));
+}
+
+#endif
+
+}  // namespace
+
+void ConvertYuv420ToRgba(const Yuv420Frame &src, int step, uint8_t *dst,
+                         int dst_stride) {
+  if (step < 1) {
+    step = 1;
+  }
+  int out_width = src.width / step;
+  int out_height = src.height / step;
+  for (int row = 0; row < out_height; row++) {
+    int sy = row * step;
+    uint8_t *dst_row = dst + row * dst_stride;
+    int x = 0;
+#if defined(ROW_BLOCK)
+    if (step == 1) {
+      const uint8_t *y_row = src.y + sy * src.y_stride;
+      int chroma_offset = (sy / 2) * src.chroma_stride;
+      for (; x + ROW_BLOCK <= out_width; x += ROW_BLOCK) {
+        int chroma = chroma_offset + (x / 2) * src.chroma_pixel_stride;
+        ConvertBlock(y_row + x, src.u + chroma, src.v + chroma,
+                     src.chroma_pixel_stride, dst_row + x * 4);
+      }
+    }
+#endif
+    ConvertRowScalar(src, sy, x, out_width - x, step, dst_row + x * 4);
+  }
+}
+
+void DownscaleRgba(const uint8_t *src, int width, int height, int src_stride,
+                   int step, uint8_t *dst, int dst_stride) {
+  if (step <= 1) {
+    for (int row = 0; row < height; row++) {
+      memcpy(dst + row * dst_stride, src + row * src_stride, width * 4);
+    }
+    return;
+  }
+  int out_width = width / step;
+  int out_height = height / step;
+  int area = step * step;
+  for (int row = 0; row < out_height; row++) {
+    uint8_t *dst_row = dst + row * dst_stride;
+    for (int x = 0; x < out_width; x++) {
+      int sum[4] = {0, 0, 0, 0};
+      for (int dy = 0; dy < step; dy++) {
+        const uint8_t *p =
+            src + (row * step + dy) * src_stride + x * step * 4;
+        for (int dx = 0; dx < step; dx++, p += 4) {
+          sum[0] += p[0];
+          sum[1] += p[1];
+          sum[2] += p[2];
+          sum[3] += p[3];
+        }
+      }
+      for (int i = 0; i < 4; i++) {
+        dst_row[x * 4 + i] = (sum[i] + area / 2) / area;
+      }
+    }
+  }
+}
+
+void ScalePlane(const uint8_t *src, int src_width, int src_height,
+                int src_stride, int src_pixel_stride, uint8_t *dst,
+                int dst_width, int dst_height, int dst_stride) {
+  if (dst_width <= 0 || dst_height <= 0) {
+    return;
+  }
+  // The source columns covered by each destination column.
+  std::vector<int> x_begin(dst_width), x_end(dst_width);
+  for (int x = 0; x < dst_width; x++) {
+    x_begin[x] = x * src_width / dst_width;
+    x_end[x] = std::max((x + 1) * src_width / dst_width, x_begin[x] + 1);
+  }
+  std::vector<uint32_t> sums(dst_width);
+  for (int row = 0; row < dst_height; row++) {
+    int y_begin = row * src_height / dst_height;
+    int y_end = std::max((row + 1) * src_height / dst_height, y_begin + 1);
+    std::fill(sums.begin(), sums.end(), 0);
+    for (int sy = y_begin; sy < y_end; sy++) {
+      const uint8_t *src_row = src + sy * src_stride;
+      for (int x = 0; x < dst_width; x++) {
+        uint32_t sum = 0;
+        for (int sx = x_begin[x]; sx < x_end[x]; sx++) {
+          sum += src_row[sx * src_pixel_stride];
+        }
+        sums[x] += sum;
+      }
+    }
+    uint8_t *dst_row = dst + row * dst_stride;
+    for (int x = 0; x < dst_width; x++) {
+      uint32_t area = (x_end[x] - x_begin[x]) * (y_end - y_begin);
+      dst_row[x] = (sums[x] + area / 2) / area;
+    }
+  }
+}
+
+const char *GetColorConvertBackend() {
+#if defined(COLOR_CONVERT_NEON)
+  return "neon";
+#elif defined(COLOR_CONVERT_SSE2)
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
@@ -0,0 +1,49 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_COLOR_CONVERT_H_
+#define FLUTTER_PLUGIN_COLOR_CONVERT_H_
+
+#include <cstdint>
+
+// A 4:2:0 frame. |chroma_pixel_stride| is 1 for planar formats (I420, YV12)
+// and 2 for semi-planar formats (NV12, NV21), where |u| and |v| point into
+// the same interleaved plane.
+struct Yuv420Frame {
+  int width{0};
+  int height{0};
+  const uint8_t *y{nullptr};
+  int y_stride{0};
+  const uint8_t *u{nullptr};
+  const uint8_t *v{nullptr};
+  int chroma_stride{0};
+  int chroma_pixel_stride{1};
+};
+
+// Converts |src| to RGBA8888 (BT.601, limited range), taking every |step|-th
+// pixel of every |step|-th row. |dst| must hold (height / step) rows of
+// |dst_stride| bytes, each at least (width / step) * 4 bytes long.
+//
+// Full size conversions of I420/YV12/NV12/NV21 use NEON or SSE2 if the
+// target supports them. All paths produce identical output.
+void ConvertYuv420ToRgba(const Yuv420Frame &src, int step, uint8_t *dst,
+                         int dst_stride);
+
+// Downscales an RGBA8888 image by an integer |step| by averaging each
+// |step| x |step| block.
+void DownscaleRgba(const uint8_t *src, int width, int height, int src_stride,
+                   int step, uint8_t *dst, int dst_stride);
+
+// Scales a plane of 8-bit samples to |dst_width| x |dst_height| by averaging
+// the source area covered by each destination sample. |src_pixel_stride| is
+// the distance between two samples of the plane, e.g. 2 for one component
+// of an interleaved UV plane.
+void ScalePlane(const uint8_t *src, int src_width, int src_height,
+                int src_stride, int src_pixel_stride, uint8_t *dst,
+                int dst_width, int dst_height, int dst_stride);
+
+// Returns "neon", "sse2" or "scalar".
+const char *GetColorConvertBackend();
+
+#endif
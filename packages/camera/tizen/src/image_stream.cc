@@ -0,0 +1,365 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "image_stream.h"
+
+#include <Ecore.h>
+#include <flutter/event_stream_handler_functions.h>
+#include <flutter/standard_method_codec.h>
+#include <tbm_surface.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+#include "color_convert.h"
+#include "log.h"
+
+#define IMAGE_STREAM_CHANNEL_NAME "plugins.flutter.io/camera/imageStream"
+#define FORMAT_JPEG __tbm_fourcc_code('J', 'P', 'E', 'G')
+#define FORMAT_RGBA TBM_FORMAT_ABGR8888
+
+namespace {
+
+uint64_t SteadyTimestamp() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int ChooseSubsampling(int width, int height,
+                      const ImageStreamOptions &options) {
+  int step = 1;
+  while ((options.max_width > 0 && width / step > options.max_width) ||
+         (options.max_height > 0 && height / step > options.max_height)) {
+    step++;
+  }
+  return step;
+}
+
+flutter::EncodableMap PlaneToEncodableMap(std::vector<uint8_t> &&bytes,
+                                          int stride, int bytes_per_pixel,
+                                          int width, int height) {
+  flutter::EncodableMap plane;
+  plane[flutter::EncodableValue("bytes")] =
+      flutter::EncodableValue(std::move(bytes));
+  plane[flutter::EncodableValue("bytesPerRow")] =
+      flutter::EncodableValue(stride);
+  plane[flutter::EncodableValue("bytesPerPixel")] =
+      flutter::EncodableValue(bytes_per_pixel);
+  plane[flutter::EncodableValue("width")] = flutter::EncodableValue(width);
+  plane[flutter::EncodableValue("height")] = flutter::EncodableValue(height);
+  return plane;
+}
+
+// Copies a plane of |width| x |height| pixels, taking every |step|-th pixel
+// of every |step|-th row.
+flutter::EncodableMap CreatePlane(const unsigned char *data, int stride,
+                                  int width, int height, int bytes_per_pixel,
+                                  int step) {
+  int out_width = width / step;
+  int out_height = height / step;
+  int out_stride = out_width * bytes_per_pixel;
+  std::vector<uint8_t> bytes;
+  if (step == 1 && stride == out_stride) {
+    bytes.assign(data, data + static_cast<size_t>(out_stride) * out_height);
+  } else {
+    bytes.resize(static_cast<size_t>(out_stride) * out_height);
+    uint8_t *dst = bytes.data();
+    for (int y = 0; y < out_height; y++) {
+      const unsigned char *src_row =
+          data + static_cast<size_t>(y) * step * stride;
+      if (step == 1) {
+        memcpy(dst, src_row, out_stride);
+        dst += out_stride;
+        continue;
+      }
+      for (int x = 0; x < out_width; x++) {
+        memcpy(dst, src_row + x * step * bytes_per_pixel, bytes_per_pixel);
+        dst += bytes_per_pixel;
+      }
+    }
+  }
+
+  return PlaneToEncodableMap(std::move(bytes), out_stride, bytes_per_pixel,
+                             out_width, out_height);
+}
+
+bool ToYuv420Frame(const tbm_surface_info_s &info, Yuv420Frame &frame) {
+  frame.width = info.width;
+  frame.height = info.height;
+  frame.y = info.planes[0].ptr;
+  frame.y_stride = info.planes[0].stride;
+  switch (info.format) {
+    case TBM_FORMAT_NV12:
+    case TBM_FORMAT_NV21: {
+      const uint8_t *uv = info.planes[1].ptr;
+      bool is_nv12 = info.format == TBM_FORMAT_NV12;
+      frame.u = is_nv12 ? uv : uv + 1;
+      frame.v = is_nv12 ? uv + 1 : uv;
+      frame.chroma_stride = info.planes[1].stride;
+      frame.chroma_pixel_stride = 2;
+      return true;
+    }
+    case TBM_FORMAT_YUV420:
+    case TBM_FORMAT_YVU420: {
+      bool is_i420 = info.format == TBM_FORMAT_YUV420;
+      frame.u = info.planes[is_i420 ? 1 : 2].ptr;
+      frame.v = info.planes[is_i420 ? 2 : 1].ptr;
+      frame.chroma_stride = info.planes[1].stride;
+      frame.chroma_pixel_stride = 1;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+flutter::EncodableMap CreateRgbaPlane(const Yuv420Frame &frame, int step) {
+  int out_width = frame.width / step;
+  int out_height = frame.height / step;
+  int out_stride = out_width * 4;
+  std::vector<uint8_t> bytes(static_cast<size_t>(out_stride) * out_height);
+  ConvertYuv420ToRgba(frame, step, bytes.data(), out_stride);
+  return PlaneToEncodableMap(std::move(bytes), out_stride, 4, out_width,
+                             out_height);
+}
+
+// Scales |frame| to |width| x |height| and appends the resulting I420 planes,
+// or a single RGBA plane if |rgba| is true, to |planes|. Scaling first keeps
+// the color conversion cost proportional to the output size.
+void AppendAnalysisPlanes(const Yuv420Frame &frame, int width, int height,
+                          bool rgba, flutter::EncodableList &planes) {
+  int chroma_width = width / 2;
+  int chroma_height = height / 2;
+  std::vector<uint8_t> y(static_cast<size_t>(width) * height);
+  std::vector<uint8_t> u(static_cast<size_t>(chroma_width) * chroma_height);
+  std::vector<uint8_t> v(static_cast<size_t>(chroma_width) * chroma_height);
+  ScalePlane(frame.y, frame.width, frame.height, frame.y_stride, 1, y.data(),
+             width, height, width);
+  ScalePlane(frame.u, frame.width / 2, frame.height / 2, frame.chroma_stride,
+             frame.chroma_pixel_stride, u.data(), chroma_width, chroma_height,
+             chroma_width);
+  ScalePlane(frame.v, frame.width / 2, frame.height / 2, frame.chroma_stride,
+             frame.chroma_pixel_stride, v.data(), chroma_width, chroma_height,
+             chroma_width);
+  if (rgba) {
+    Yuv420Frame scaled;
+    scaled.width = width;
+    scaled.height = height;
+    scaled.y = y.data();
+    scaled.y_stride = width;
+    scaled.u = u.data();
+    scaled.v = v.data();
+    scaled.chroma_stride = chroma_width;
+    scaled.chroma_pixel_stride = 1;
+    planes.push_back(flutter::EncodableValue(CreateRgbaPlane(scaled, 1)));
+    return;
+  }
+  planes.push_back(flutter::EncodableValue(
+      PlaneToEncodableMap(std::move(y), width, 1, width, height)));
+  planes.push_back(flutter::EncodableValue(PlaneToEncodableMap(
+      std::move(u), chroma_width, 1, chroma_width, chroma_height)));
+  planes.push_back(flutter::EncodableValue(PlaneToEncodableMap(
+      std::move(v), chroma_width, 1, chroma_width, chroma_height)));
+}
+
+}  // namespace
+
+ImageStream::ImageStream(flutter::PluginRegistrar *registrar) {
+  event_channel_ =
+      std::make_unique<flutter::EventChannel<flutter::EncodableValue>>(
+          registrar->messenger(), IMAGE_STREAM_CHANNEL_NAME,
+          &flutter::StandardMethodCodec::GetInstance());
+  auto handler = std::make_unique<flutter::StreamHandlerFunctions<>>(
+      [this](const flutter::EncodableValue *arguments,
+             std::unique_ptr<flutter::EventSink<>> &&events)
+          -> std::unique_ptr<flutter::StreamHandlerError<>> {
+        LOG_DEBUG("OnListen");
+        event_sink_ = std::move(events);
+        return nullptr;
+      },
+      [this](const flutter::EncodableValue *arguments)
+          -> std::unique_ptr<flutter::StreamHandlerError<>> {
+        LOG_DEBUG("OnCancel");
+        event_sink_ = nullptr;
+        return nullptr;
+      });
+  event_channel_->SetStreamHandler(std::move(handler));
+}
+
+ImageStream::~ImageStream() {
+  Stop();
+  alive_ = nullptr;
+}
+
+void ImageStream::Start(const ImageStreamOptions &options) {
+  LOG_DEBUG(
+      "max_fps[%d] max_width[%d] max_height[%d] analysis[%dx%d] format[%d]",
+      options.max_fps, options.max_width, options.max_height,
+      options.analysis_width, options.analysis_height,
+      static_cast<int>(options.format));
+  std::atomic_store(&options_,
+                    std::make_shared<const ImageStreamOptions>(options));
+  last_frame_time_ms_ = 0;
+  dropped_frames_ = 0;
+  is_active_ = true;
+}
+
+void ImageStream::Stop() {
+  is_active_ = false;
+  std::lock_guard<std::mutex> lock(pending_frame_mutex_);
+  pending_frame_ = nullptr;
+}
+
+bool ImageStream::ShouldSkipFrame(const ImageStreamOptions &options,
+                                  uint64_t now) {
+  if (options.max_fps <= 0) {
+    return false;
+  }
+  uint64_t last_frame_time_ms = last_frame_time_ms_;
+  return last_frame_time_ms != 0 &&
+         now - last_frame_time_ms < 1000UL / options.max_fps;
+}
+
+void ImageStream::OnPreviewPacket(media_packet_h packet) {
+  if (!is_active_) {
+    return;
+  }
+  std::shared_ptr<const ImageStreamOptions> options =
+      std::atomic_load(&options_);
+  uint64_t now = SteadyTimestamp();
+  if (!options || ShouldSkipFrame(*options, now)) {
+    return;
+  }
+  // Backpressure: drop the frame if the previous one is still on its way.
+  if (is_frame_in_flight_.exchange(true)) {
+    dropped_frames_++;
+    return;
+  }
+
+  std::unique_ptr<flutter::EncodableMap> frame = CreateFrame(packet, *options);
+  if (!frame) {
+    is_frame_in_flight_ = false;
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(pending_frame_mutex_);
+    pending_frame_ = std::move(frame);
+  }
+  // Only frames that are sent count towards max_fps, so that a dropped
+  // frame does not delay the next one.
+  last_frame_time_ms_ = now;
+  ecore_main_loop_thread_safe_call_async(
+      DeliverFrame, new DeliveryRequest{this, alive_});
+}
+
+void ImageStream::DeliverFrame(void *data) {
+  std::unique_ptr<DeliveryRequest> request(
+      static_cast<DeliveryRequest *>(data));
+  // The stream is destroyed on this thread, so it cannot go away after this
+  // check.
+  if (request->alive.expired()) {
+    return;
+  }
+  ImageStream *self = request->stream;
+  std::unique_ptr<flutter::EncodableMap> frame;
+  {
+    std::lock_guard<std::mutex> lock(self->pending_frame_mutex_);
+    frame = std::move(self->pending_frame_);
+  }
+  if (frame && self->is_active_ && self->event_sink_) {
+    self->event_sink_->Success(flutter::EncodableValue(*frame));
+  }
+  self->is_frame_in_flight_ = false;
+}
+
+std::unique_ptr<flutter::EncodableMap> ImageStream::CreateFrame(
+    media_packet_h packet, const ImageStreamOptions &options) {
+  auto frame = std::make_unique<flutter::EncodableMap>();
+  flutter::EncodableList planes;
+  int width = 0, height = 0;
+  int64_t format = 0;
+
+  tbm_surface_h surface = nullptr;
+  tbm_surface_info_s info;
+  if (media_packet_get_tbm_surface(packet, &surface) ==
+          MEDIA_PACKET_ERROR_NONE &&
+      surface &&
+      tbm_surface_map(surface, TBM_SURF_OPTION_READ, &info) ==
+          TBM_SURFACE_ERROR_NONE) {
+    int step = ChooseSubsampling(info.width, info.height, options);
+    width = info.width / step;
+    height = info.height / step;
+    format = info.format;
+    Yuv420Frame yuv_frame;
+    bool is_yuv420 = ToYuv420Frame(info, yuv_frame);
+    bool is_rgba = options.format == ImageStreamFormat::kRgba;
+    if (is_yuv420 && options.analysis_width > 0 &&
+        options.analysis_height > 0) {
+      // Start() only accepts sizes within the preview size, but the preview
+      // may have been resized since. Never upscale. Chroma planes need even
+      // dimensions.
+      width = std::max(std::min<int>(options.analysis_width, info.width) & ~1,
+                       2);
+      height = std::max(
+          std::min<int>(options.analysis_height, info.height) & ~1, 2);
+      format = is_rgba ? FORMAT_RGBA : TBM_FORMAT_YUV420;
+      AppendAnalysisPlanes(yuv_frame, width, height, is_rgba, planes);
+    } else if (is_yuv420 && is_rgba) {
+      format = FORMAT_RGBA;
+      planes.push_back(
+          flutter::EncodableValue(CreateRgbaPlane(yuv_frame, step)));
+    }
+    for (uint32_t i = 0; planes.empty() && i < info.num_planes; i++) {
+      int plane_width = info.width;
+      int plane_height = info.height;
+      int bytes_per_pixel = 1;
+      if (i > 0) {
+        // Chroma planes of 4:2:0 formats are subsampled in both directions.
+        plane_width /= 2;
+        plane_height /= 2;
+        if (info.num_planes == 2) {
+          // NV12/NV21 interleave U and V samples.
+          bytes_per_pixel = 2;
+        }
+      }
+      planes.push_back(flutter::EncodableValue(
+          CreatePlane(info.planes[i].ptr, info.planes[i].stride, plane_width,
+                      plane_height, bytes_per_pixel, step)));
+    }
+    tbm_surface_unmap(surface);
+  } else {
+    // Encoded (JPEG) preview frames have no tbm surface.
+    void *data = nullptr;
+    uint64_t size = 0;
+    if (media_packet_get_buffer_data_ptr(packet, &data) !=
+            MEDIA_PACKET_ERROR_NONE ||
+        media_packet_get_buffer_size(packet, &size) !=
+            MEDIA_PACKET_ERROR_NONE ||
+        !data || !size) {
+      LOG_ERROR("Failed to get data of a preview packet");
+      return nullptr;
+    }
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    flutter::EncodableMap plane;
+    plane[flutter::EncodableValue("bytes")] =
+        flutter::EncodableValue(std::vector<uint8_t>(bytes, bytes + size));
+    plane[flutter::EncodableValue("bytesPerRow")] =
+        flutter::EncodableValue(static_cast<int64_t>(size));
+    plane[flutter::EncodableValue("bytesPerPixel")] =
+        flutter::EncodableValue(1);
+    planes.push_back(flutter::EncodableValue(plane));
+    format = FORMAT_JPEG;
+  }
+
+  // The raw format is a tbm fourcc (e.g. NV12, YU12) so that consumers can
+  // tell the plane layout apart.
+  (*frame)[flutter::EncodableValue("format")] = flutter::EncodableValue(format);
+  (*frame)[flutter::EncodableValue("width")] = flutter::EncodableValue(width);
+  (*frame)[flutter::EncodableValue("height")] = flutter::EncodableValue(height);
+  (*frame)[flutter::EncodableValue("planes")] = flutter::EncodableValue(planes);
+  return frame;
+}
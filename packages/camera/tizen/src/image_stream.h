@@ -0,0 +1,92 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_IMAGE_STREAM_H_
+#define FLUTTER_PLUGIN_IMAGE_STREAM_H_
+
+#include <flutter/encodable_value.h>
+#include <flutter/event_channel.h>
+#include <flutter/plugin_registrar.h>
+#include <media_packet.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+enum class ImageStreamFormat {
+  // The planes of the preview buffer as they are.
+  kRaw,
+  // A single RGBA8888 plane, converted natively from 4:2:0 YUV previews.
+  kRgba,
+};
+
+struct ImageStreamOptions {
+  // The maximum number of frames per second to deliver. 0 means unlimited.
+  int max_fps{0};
+  // The maximum size of delivered frames. Larger frames are subsampled by an
+  // integer factor. 0 means the preview size.
+  int max_width{0};
+  int max_height{0};
+  // If set, 4:2:0 YUV frames are scaled down to this size (area averaged)
+  // and delivered as I420, or as RGBA if |format| is kRgba. Both values must
+  // be set and at most the preview size. This takes precedence over
+  // |max_width| and |max_height|.
+  int analysis_width{0};
+  int analysis_height{0};
+  ImageStreamFormat format{ImageStreamFormat::kRaw};
+};
+
+// Delivers preview frames to Dart through the
+// plugins.flutter.io/camera/imageStream event channel.
+//
+// Frames are offered on the camera thread and delivered on the platform
+// thread. At most one frame is in flight at a time; frames offered while the
+// previous one has not been delivered yet are dropped rather than queued.
+// All other methods, including the destructor, must be called on the platform
+// thread.
+class ImageStream {
+ public:
+  explicit ImageStream(flutter::PluginRegistrar *registrar);
+  ~ImageStream();
+
+  void Start(const ImageStreamOptions &options);
+  void Stop();
+  bool IsActive() { return is_active_; }
+
+  // Called on the camera thread. Does not take the ownership of |packet|.
+  void OnPreviewPacket(media_packet_h packet);
+
+  uint64_t GetDroppedFrameCount() { return dropped_frames_; }
+
+ private:
+  // Passed to DeliverFrame(), which may run after this stream is destroyed.
+  struct DeliveryRequest {
+    ImageStream *stream;
+    std::weak_ptr<void> alive;
+  };
+
+  static void DeliverFrame(void *data);
+  bool ShouldSkipFrame(const ImageStreamOptions &options, uint64_t now);
+  std::unique_ptr<flutter::EncodableMap> CreateFrame(
+      media_packet_h packet, const ImageStreamOptions &options);
+
+  std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
+      event_channel_;
+  std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink_;
+
+  // An immutable snapshot published by Start() and read by the camera
+  // thread with std::atomic_load().
+  std::shared_ptr<const ImageStreamOptions> options_;
+  std::atomic<bool> is_active_{false};
+  std::atomic<bool> is_frame_in_flight_{false};
+  std::atomic<uint64_t> dropped_frames_{0};
+  std::atomic<uint64_t> last_frame_time_ms_{0};
+  // Expires when this stream is destroyed.
+  std::shared_ptr<void> alive_{std::make_shared<int>(0)};
+
+  std::mutex pending_frame_mutex_;
+  std::unique_ptr<flutter::EncodableMap> pending_frame_;
+};
+
+#endif
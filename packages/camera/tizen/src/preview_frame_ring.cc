@@ -0,0 +1,151 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "preview_frame_ring.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+uint64_t MonotonicTimestampUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+size_t ClampCapacity(size_t capacity) {
+  return std::min(std::max(capacity, static_cast<size_t>(1)),
+                  PreviewFrameRing::kMaxCapacity);
+}
+
+}  // namespace
+
+PreviewFrameRing::PreviewFrameRing(size_t capacity,
+                                   PreviewFrameDropPolicy drop_policy)
+    : capacity_(ClampCapacity(capacity)), drop_policy_(drop_policy) {}
+
+PreviewFrameRing::~PreviewFrameRing() { Clear(); }
+
+bool PreviewFrameRing::Push(media_packet_h packet) {
+  uint64_t now = MonotonicTimestampUs();
+  produced_.fetch_add(1, std::memory_order_relaxed);
+  last_produced_us_.store(now, std::memory_order_relaxed);
+
+  uint64_t tail = tail_.load(std::memory_order_relaxed);
+  uint64_t head = head_.load();
+  while (tail - head >= capacity_) {
+    if (drop_policy_ == PreviewFrameDropPolicy::kDropNewest) {
+      media_packet_destroy(packet);
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    // Only this thread writes the packets, so the oldest one cannot change
+    // until the read index moves past it. Whoever moves it owns the packet.
+    media_packet_h oldest =
+        packets_[head % kMaxCapacity].load(std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head, head + 1)) {
+      media_packet_destroy(oldest);
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      head++;
+    }
+  }
+  produced_us_[tail % kMaxCapacity].store(now, std::memory_order_relaxed);
+  packets_[tail % kMaxCapacity].store(packet, std::memory_order_relaxed);
+  tail_.store(tail + 1);
+  // Checked after the packet is published: if an older packet is still
+  // queued, the consumer comes back for this one when it is done with that
+  // one. Otherwise it may be idle and must be notified.
+  return head_.load() >= tail;
+}
+
+media_packet_h PreviewFrameRing::Claim(uint64_t *produced_us) {
+  uint64_t head = head_.load();
+  while (head != tail_.load()) {
+    // May be overwritten by a later push once the producer has dropped this
+    // packet, in which case the compare-and-swap below fails.
+    media_packet_h packet =
+        packets_[head % kMaxCapacity].load(std::memory_order_relaxed);
+    *produced_us = produced_us_[head % kMaxCapacity].load(
+        std::memory_order_relaxed);
+    if (head_.compare_exchange_weak(head, head + 1)) {
+      return packet;
+    }
+  }
+  return nullptr;
+}
+
+media_packet_h PreviewFrameRing::Pop(tbm_surface_h *surface) {
+  uint64_t produced_us = 0;
+  while (media_packet_h packet = Claim(&produced_us)) {
+    int ret = media_packet_get_tbm_surface(packet, surface);
+    if (ret != MEDIA_PACKET_ERROR_NONE || !*surface) {
+      media_packet_destroy(packet);
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    uint64_t now = MonotonicTimestampUs();
+    uint64_t delay = now > produced_us ? now - produced_us : 0;
+    presented_.fetch_add(1, std::memory_order_relaxed);
+    last_presented_us_.store(now, std::memory_order_relaxed);
+    last_queue_delay_us_.store(delay, std::memory_order_relaxed);
+    if (delay > max_queue_delay_us_.load(std::memory_order_relaxed)) {
+      // Only the consumer writes this value.
+      max_queue_delay_us_.store(delay, std::memory_order_relaxed);
+    }
+    return packet;
+  }
+  return nullptr;
+}
+
+void PreviewFrameRing::Clear() {
+  uint64_t produced_us = 0;
+  while (media_packet_h packet = Claim(&produced_us)) {
+    media_packet_destroy(packet);
+  }
+}
+
+size_t PreviewFrameRing::GetSize() {
+  // The read index is loaded first, so that the difference never underflows.
+  uint64_t head = head_.load();
+  return static_cast<size_t>(tail_.load() - head);
+}
+
+void PreviewFrameRing::SetCapacity(size_t capacity) {
+  capacity_ = ClampCapacity(capacity);
+}
+
+void PreviewFrameRing::ResetStats() {
+  produced_ = 0;
+  presented_ = 0;
+  dropped_ = 0;
+  last_produced_us_ = 0;
+  last_presented_us_ = 0;
+  last_queue_delay_us_ = 0;
+  max_queue_delay_us_ = 0;
+}
+
+flutter::EncodableMap PreviewFrameRing::StatsToEncodableMap() {
+  flutter::EncodableMap map;
+  map[flutter::EncodableValue("capacity")] =
+      flutter::EncodableValue(static_cast<int64_t>(capacity_.load()));
+  map[flutter::EncodableValue("dropPolicy")] = flutter::EncodableValue(
+      drop_policy_ == PreviewFrameDropPolicy::kDropNewest ? "newest"
+                                                          : "oldest");
+  map[flutter::EncodableValue("produced")] =
+      flutter::EncodableValue(static_cast<int64_t>(produced_.load()));
+  map[flutter::EncodableValue("presented")] =
+      flutter::EncodableValue(static_cast<int64_t>(presented_.load()));
+  map[flutter::EncodableValue("dropped")] =
+      flutter::EncodableValue(static_cast<int64_t>(dropped_.load()));
+  map[flutter::EncodableValue("lastProducedUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(last_produced_us_.load()));
+  map[flutter::EncodableValue("lastPresentedUs")] =
+      flutter::EncodableValue(static_cast<int64_t>(last_presented_us_.load()));
+  map[flutter::EncodableValue("lastQueueDelayUs")] = flutter::EncodableValue(
+      static_cast<int64_t>(last_queue_delay_us_.load()));
+  map[flutter::EncodableValue("maxQueueDelayUs")] = flutter::EncodableValue(
+      static_cast<int64_t>(max_queue_delay_us_.load()));
+  return map;
+}
@@ -0,0 +1,94 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_PREVIEW_FRAME_RING_H_
+#define FLUTTER_PLUGIN_PREVIEW_FRAME_RING_H_
+
+#include <flutter/encodable_value.h>
+#include <media_packet.h>
+
+#include <atomic>
+#include <cstdint>
+
+enum class PreviewFrameDropPolicy {
+  // A push into a full ring destroys the oldest packet, so that the preview
+  // shows the newest frame.
+  kDropOldest,
+  // A push into a full ring destroys the pushed packet, so that the frames
+  // already queued are shown without gaps.
+  kDropNewest,
+};
+
+// A bounded FIFO of preview packets between the camera thread (the single
+// producer) and the raster thread (the single consumer). Neither thread ever
+// waits for the other: both sides only use atomic operations on the ring
+// indices, and a packet is owned by whoever advances the read index past it.
+//
+// Dropped packets are destroyed and counted. The capacity and the drop
+// policy may be changed from any thread at any time.
+class PreviewFrameRing {
+ public:
+  static constexpr size_t kDefaultCapacity = 2;
+  static constexpr size_t kMaxCapacity = 8;
+
+  explicit PreviewFrameRing(
+      size_t capacity = kDefaultCapacity,
+      PreviewFrameDropPolicy drop_policy = PreviewFrameDropPolicy::kDropOldest);
+  ~PreviewFrameRing();
+
+  // Producer. Takes the ownership of |packet|. Returns true if the ring was
+  // empty, i.e. the consumer has to be notified of a new frame.
+  bool Push(media_packet_h packet);
+
+  // Consumer. Returns the oldest packet that has a tbm surface and passes its
+  // ownership to the caller, or nullptr if there is none. Packets without a
+  // surface are destroyed and counted as dropped.
+  media_packet_h Pop(tbm_surface_h *surface);
+
+  // Consumer. Destroys all queued packets.
+  void Clear();
+
+  bool IsEmpty() { return head_.load() == tail_.load(); }
+  size_t GetSize();
+  size_t GetCapacity() { return capacity_; }
+  // If the ring holds more packets than the new capacity, the next push drops
+  // the oldest ones (kDropOldest) or the consumer drains them (kDropNewest).
+  void SetCapacity(size_t capacity);
+  PreviewFrameDropPolicy GetDropPolicy() { return drop_policy_; }
+  void SetDropPolicy(PreviewFrameDropPolicy drop_policy) {
+    drop_policy_ = drop_policy;
+  }
+
+  void ResetStats();
+  flutter::EncodableMap StatsToEncodableMap();
+
+ private:
+  // Advances the read index past the oldest packet and returns it, or returns
+  // nullptr if the ring is empty. Only called by the consumer.
+  media_packet_h Claim(uint64_t *produced_us);
+
+  // Indexed by the ring indices modulo kMaxCapacity, so that the capacity can
+  // change while packets are queued.
+  std::atomic<media_packet_h> packets_[kMaxCapacity] = {};
+  std::atomic<uint64_t> produced_us_[kMaxCapacity] = {};
+  // Both only ever grow. |tail_| is written by the producer. |head_| is
+  // advanced with compare-and-swap by the consumer, and by the producer when
+  // it drops the oldest packet.
+  std::atomic<uint64_t> head_{0};
+  std::atomic<uint64_t> tail_{0};
+  std::atomic<size_t> capacity_;
+  std::atomic<PreviewFrameDropPolicy> drop_policy_;
+
+  std::atomic<uint64_t> produced_{0};
+  std::atomic<uint64_t> presented_{0};
+  std::atomic<uint64_t> dropped_{0};
+  // Timestamps are in microseconds of the monotonic clock. 0 means never.
+  std::atomic<uint64_t> last_produced_us_{0};
+  std::atomic<uint64_t> last_presented_us_{0};
+  // The time the last presented frame spent in the ring.
+  std::atomic<uint64_t> last_queue_delay_us_{0};
+  std::atomic<uint64_t> max_queue_delay_us_{0};
+};
+
+#endif
@@ -0,0 +1,81 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#include "color_convert.h"
+
+namespace {
+
+void Measure(const char *name, int iterations,
+             const std::function<void()> &function) {
+  function();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    function();
+  }
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  printf("%-32s %8.3f ms\n", name, elapsed.count() / iterations);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 50;
+  const int width = 1920;
+  const int height = 1080;
+  std::vector<uint8_t> y(width * height);
+  std::vector<uint8_t> uv(width * height / 2);
+  for (size_t i = 0; i < y.size(); i++) {
+    y[i] = static_cast<uint8_t>(i * 7);
+  }
+  for (size_t i = 0; i < uv.size(); i++) {
+    uv[i] = static_cast<uint8_t>(i * 13);
+  }
+  std::vector<uint8_t> rgba(width * height * 4);
+
+  Yuv420Frame nv12;
+  nv12.width = width;
+  nv12.height = height;
+  nv12.y = y.data();
+  nv12.y_stride = width;
+  nv12.u = uv.data();
+  nv12.v = uv.data() + 1;
+  nv12.chroma_stride = width;
+  nv12.chroma_pixel_stride = 2;
+
+  Yuv420Frame i420 = nv12;
+  i420.u = uv.data();
+  i420.v = uv.data() + width * height / 4;
+  i420.chroma_stride = width / 2;
+  i420.chroma_pixel_stride = 1;
+
+  printf("Backend: %s, %dx%d, %d iterations\n", GetColorConvertBackend(),
+         width, height, iterations);
+  Measure("NV12 to RGBA", iterations, [&]() {
+    ConvertYuv420ToRgba(nv12, 1, rgba.data(), width * 4);
+  });
+  Measure("I420 to RGBA", iterations, [&]() {
+    ConvertYuv420ToRgba(i420, 1, rgba.data(), width * 4);
+  });
+  Measure("NV12 to RGBA, step 2", iterations, [&]() {
+    ConvertYuv420ToRgba(nv12, 2, rgba.data(), width * 2);
+  });
+  std::vector<uint8_t> downscaled(width * height);
+  Measure("DownscaleRgba, step 2", iterations, [&]() {
+    DownscaleRgba(rgba.data(), width, height, width * 4, 2,
+                  downscaled.data(), width * 2);
+  });
+  std::vector<uint8_t> plane(320 * 240);
+  Measure("ScalePlane Y to 320x240", iterations, [&]() {
+    ScalePlane(y.data(), width, height, width, 1, plane.data(), 320, 240,
+               320);
+  });
+  return 0;
+}
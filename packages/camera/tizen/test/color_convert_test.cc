@@ -0,0 +1,309 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "color_convert.h"
+#include "test_util.h"
+
+namespace {
+
+enum class Layout { kI420, kYv12, kNv12, kNv21 };
+
+const char *LayoutName(Layout layout) {
+  switch (layout) {
+    case Layout::kI420:
+      return "I420";
+    case Layout::kYv12:
+      return "YV12";
+    case Layout::kNv12:
+      return "NV12";
+    default:
+      return "NV21";
+  }
+}
+
+// A 4:2:0 frame with padded rows, owning its planes.
+struct TestFrame {
+  std::vector<uint8_t> y;
+  std::vector<uint8_t> chroma1;
+  std::vector<uint8_t> chroma2;
+  Yuv420Frame frame;
+};
+
+TestFrame CreateFrame(int width, int height, int y_padding,
+                      int chroma_padding, Layout layout, std::mt19937 &rng) {
+  TestFrame test;
+  int chroma_width = (width + 1) / 2;
+  int chroma_height = (height + 1) / 2;
+  Yuv420Frame &frame = test.frame;
+  frame.width = width;
+  frame.height = height;
+  frame.y_stride = width + y_padding;
+  test.y.resize(frame.y_stride * height);
+  bool is_planar = layout == Layout::kI420 || layout == Layout::kYv12;
+  frame.chroma_pixel_stride = is_planar ? 1 : 2;
+  frame.chroma_stride = chroma_width * frame.chroma_pixel_stride +
+                        chroma_padding;
+  test.chroma1.resize(frame.chroma_stride * chroma_height);
+  test.chroma2.resize(is_planar ? test.chroma1.size() : 0);
+  for (auto *plane : {&test.y, &test.chroma1, &test.chroma2}) {
+    for (uint8_t &value : *plane) {
+      value = static_cast<uint8_t>(rng());
+    }
+  }
+  switch (layout) {
+    case Layout::kI420:
+      frame.u = test.chroma1.data();
+      frame.v = test.chroma2.data();
+      break;
+    case Layout::kYv12:
+      frame.v = test.chroma1.data();
+      frame.u = test.chroma2.data();
+      break;
+    case Layout::kNv12:
+      frame.u = test.chroma1.data();
+      frame.v = test.chroma1.data() + 1;
+      break;
+    case Layout::kNv21:
+      frame.v = test.chroma1.data();
+      frame.u = test.chroma1.data() + 1;
+      break;
+  }
+  frame.y = test.y.data();
+  return test;
+}
+
+uint8_t ReferenceClamp(int value) {
+  return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+// A straightforward implementation of the documented fixed-point BT.601
+// conversion, independent of the optimized paths.
+void ReferenceConvert(const Yuv420Frame &src, int step, uint8_t *dst,
+                      int dst_stride) {
+  for (int row = 0; row < src.height / step; row++) {
+    for (int x = 0; x < src.width / step; x++) {
+      int sx = x * step;
+      int sy = row * step;
+      int chroma =
+          (sy / 2) * src.chroma_stride + (sx / 2) * src.chroma_pixel_stride;
+      int c = 74 * (src.y[sy * src.y_stride + sx] - 16) + 32;
+      int d = src.u[chroma] - 128;
+      int e = src.v[chroma] - 128;
+      uint8_t *p = dst + row * dst_stride + x * 4;
+      p[0] = ReferenceClamp((c + 102 * e) >> 6);
+      p[1] = ReferenceClamp((c - 25 * d - 52 * e) >> 6);
+      p[2] = ReferenceClamp((c + 129 * d) >> 6);
+      p[3] = 255;
+    }
+  }
+}
+
+bool CompareConversion(const Yuv420Frame &frame, int step, const char *name) {
+  int out_width = frame.width / step;
+  int out_height = frame.height / step;
+  // A padded destination checks that |dst_stride| is honored and that
+  // nothing is written past the end of a row.
+  int dst_stride = out_width * 4 + 12;
+  std::vector<uint8_t> actual(dst_stride * out_height, 0xAB);
+  std::vector<uint8_t> expected(dst_stride * out_height, 0xAB);
+  ConvertYuv420ToRgba(frame, step, actual.data(), dst_stride);
+  ReferenceConvert(frame, step, expected.data(), dst_stride);
+  if (actual != expected) {
+    for (size_t i = 0; i < actual.size(); i++) {
+      if (actual[i] != expected[i]) {
+        EXPECT(false, "%s %dx%d step %d: byte %zu is %d, expected %d", name,
+               frame.width, frame.height, step, i, actual[i], expected[i]);
+        break;
+      }
+    }
+    return false;
+  }
+  return true;
+}
+
+void TestRandomFrames() {
+  std::mt19937 rng(1);
+  for (Layout layout :
+       {Layout::kI420, Layout::kYv12, Layout::kNv12, Layout::kNv21}) {
+    for (int i = 0; i < 300; i++) {
+      // Odd and even sizes around the SIMD block widths.
+      int width = 2 + rng() % 70;
+      int height = 2 + rng() % 12;
+      int step = 1 + (i % 4 == 0 ? rng() % 3 : 0);
+      TestFrame test = CreateFrame(width, height, rng() % 9, rng() % 9,
+                                   layout, rng);
+      if (!CompareConversion(test.frame, step, LayoutName(layout))) {
+        return;
+      }
+    }
+  }
+}
+
+void TestSaturation() {
+  // Every combination of the extreme and nominal values, repeated so that
+  // each of them goes through the SIMD blocks as well as the scalar tail.
+  const int kLevels[] = {0, 1, 16, 128, 235, 240, 254, 255};
+  std::vector<int> ys, us, vs;
+  for (int y : kLevels) {
+    for (int u : kLevels) {
+      for (int v : kLevels) {
+        ys.push_back(y);
+        us.push_back(u);
+        vs.push_back(v);
+      }
+    }
+  }
+  std::mt19937 rng(2);
+  for (Layout layout :
+       {Layout::kI420, Layout::kYv12, Layout::kNv12, Layout::kNv21}) {
+    // Two luma samples share a chroma sample, so both get the same values.
+    int width = static_cast<int>(ys.size()) * 2 + 1;
+    TestFrame test = CreateFrame(width, 2, 3, 5, layout, rng);
+    Yuv420Frame &frame = test.frame;
+    for (size_t i = 0; i < ys.size(); i++) {
+      for (int row = 0; row < 2; row++) {
+        test.y[row * frame.y_stride + i * 2] = ys[i];
+        test.y[row * frame.y_stride + i * 2 + 1] = ys[i];
+      }
+      size_t chroma = i * frame.chroma_pixel_stride;
+      const_cast<uint8_t *>(frame.u)[chroma] = us[i];
+      const_cast<uint8_t *>(frame.v)[chroma] = vs[i];
+    }
+    CompareConversion(frame, 1, LayoutName(layout));
+  }
+}
+
+void TestReferenceAccuracy() {
+  // The 6-bit fixed-point coefficients stay within 3 of the exact BT.601
+  // values.
+  for (int y = 16; y <= 235; y += 7) {
+    for (int u = 16; u <= 240; u += 7) {
+      for (int v = 16; v <= 240; v += 7) {
+        uint8_t y_plane[2] = {static_cast<uint8_t>(y),
+                              static_cast<uint8_t>(y)};
+        uint8_t u_plane[1] = {static_cast<uint8_t>(u)};
+        uint8_t v_plane[1] = {static_cast<uint8_t>(v)};
+        Yuv420Frame frame;
+        frame.width = 2;
+        frame.height = 1;
+        frame.y = y_plane;
+        frame.y_stride = 2;
+        frame.u = u_plane;
+        frame.v = v_plane;
+        frame.chroma_stride = 1;
+        uint8_t rgba[8];
+        ConvertYuv420ToRgba(frame, 1, rgba, 8);
+        double c = 1.164 * (y - 16);
+        double exact[3] = {c + 1.596 * (v - 128),
+                           c - 0.392 * (u - 128) - 0.813 * (v - 128),
+                           c + 2.017 * (u - 128)};
+        for (int i = 0; i < 3; i++) {
+          double clamped = std::fmin(std::fmax(exact[i], 0.0), 255.0);
+          EXPECT(std::fabs(rgba[i] - clamped) <= 3.0,
+                 "yuv(%d, %d, %d) channel %d is %d, expected %.1f", y, u, v,
+                 i, rgba[i], clamped);
+        }
+      }
+    }
+  }
+}
+
+void TestDownscaleRgba() {
+  std::mt19937 rng(3);
+  for (int i = 0; i < 200; i++) {
+    int width = 1 + rng() % 40;
+    int height = 1 + rng() % 10;
+    int step = 1 + rng() % 4;
+    int src_stride = width * 4 + rng() % 9;
+    std::vector<uint8_t> src(src_stride * height);
+    for (uint8_t &value : src) {
+      value = static_cast<uint8_t>(rng());
+    }
+    int out_width = step == 1 ? width : width / step;
+    int out_height = step == 1 ? height : height / step;
+    int dst_stride = out_width * 4 + 8;
+    std::vector<uint8_t> actual(dst_stride * out_height, 0xAB);
+    std::vector<uint8_t> expected(dst_stride * out_height, 0xAB);
+    DownscaleRgba(src.data(), width, height, src_stride, step, actual.data(),
+                  dst_stride);
+    for (int row = 0; row < out_height; row++) {
+      for (int x = 0; x < out_width; x++) {
+        for (int c = 0; c < 4; c++) {
+          int sum = 0;
+          for (int dy = 0; dy < step; dy++) {
+            for (int dx = 0; dx < step; dx++) {
+              sum += src[(row * step + dy) * src_stride +
+                         (x * step + dx) * 4 + c];
+            }
+          }
+          int area = step * step;
+          expected[row * dst_stride + x * 4 + c] = (sum + area / 2) / area;
+        }
+      }
+    }
+    if (actual != expected) {
+      EXPECT(false, "DownscaleRgba %dx%d step %d", width, height, step);
+      return;
+    }
+  }
+}
+
+void TestScalePlane() {
+  std::mt19937 rng(4);
+  for (int i = 0; i < 200; i++) {
+    int src_width = 1 + rng() % 50;
+    int src_height = 1 + rng() % 50;
+    int pixel_stride = 1 + rng() % 2;
+    int src_stride = src_width * pixel_stride + rng() % 5;
+    int dst_width = 1 + rng() % 60;
+    int dst_height = 1 + rng() % 60;
+    std::vector<uint8_t> src(src_stride * src_height);
+    for (uint8_t &value : src) {
+      value = static_cast<uint8_t>(rng());
+    }
+    std::vector<uint8_t> dst(dst_width * dst_height);
+    ScalePlane(src.data(), src_width, src_height, src_stride, pixel_stride,
+               dst.data(), dst_width, dst_height, dst_width);
+    bool is_ok = true;
+    for (int y = 0; y < dst_height && is_ok; y++) {
+      // The exact average of the covered source area, in floating point.
+      int y0 = y * src_height / dst_height;
+      int y1 = std::max((y + 1) * src_height / dst_height, y0 + 1);
+      for (int x = 0; x < dst_width && is_ok; x++) {
+        int x0 = x * src_width / dst_width;
+        int x1 = std::max((x + 1) * src_width / dst_width, x0 + 1);
+        double sum = 0;
+        for (int sy = y0; sy < y1; sy++) {
+          for (int sx = x0; sx < x1; sx++) {
+            sum += src[sy * src_stride + sx * pixel_stride];
+          }
+        }
+        double average = sum / ((x1 - x0) * (y1 - y0));
+        is_ok = std::fabs(dst[y * dst_width + x] - average) <= 0.5;
+        EXPECT(is_ok, "ScalePlane %dx%d -> %dx%d at (%d, %d)", src_width,
+               src_height, dst_width, dst_height, x, y);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  printf("Backend: %s\n", GetColorConvertBackend());
+  TestRandomFrames();
+  TestSaturation();
+  TestReferenceAccuracy();
+  TestDownscaleRgba();
+  TestScalePlane();
+  return ReportTestResult();
+}
@@ -0,0 +1,30 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A minimal stand-in for the Flutter encodable value, used by the host tests.
+
+#ifndef FAKE_FLUTTER_ENCODABLE_VALUE_H_
+#define FAKE_FLUTTER_ENCODABLE_VALUE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <variant>
+
+namespace flutter {
+
+class EncodableValue
+    : public std::variant<std::monostate, bool, int32_t, int64_t, double,
+                          std::string> {
+ public:
+  using variant::variant;
+  // Prevents string literals from being converted to bool.
+  EncodableValue(const char *string) : variant(std::string(string)) {}
+};
+
+using EncodableMap = std::map<EncodableValue, EncodableValue>;
+
+}  // namespace flutter
+
+#endif  // FAKE_FLUTTER_ENCODABLE_VALUE_H_
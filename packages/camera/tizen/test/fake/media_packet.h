@@ -0,0 +1,21 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A minimal stand-in for the Tizen media packet API, used by the host tests.
+// The test provides the definitions of the functions.
+
+#ifndef FAKE_MEDIA_PACKET_H_
+#define FAKE_MEDIA_PACKET_H_
+
+#include <tbm_surface.h>
+
+typedef struct media_packet_s *media_packet_h;
+
+enum { MEDIA_PACKET_ERROR_NONE = 0, MEDIA_PACKET_ERROR_INVALID_PARAMETER };
+
+int media_packet_get_tbm_surface(media_packet_h packet,
+                                 tbm_surface_h *surface);
+int media_packet_destroy(media_packet_h packet);
+
+#endif  // FAKE_MEDIA_PACKET_H_
@@ -0,0 +1,12 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// A minimal stand-in for the Tizen tbm surface API, used by the host tests.
+
+#ifndef FAKE_TBM_SURFACE_H_
+#define FAKE_TBM_SURFACE_H_
+
+typedef struct _tbm_surface *tbm_surface_h;
+
+#endif  // FAKE_TBM_SURFACE_H_
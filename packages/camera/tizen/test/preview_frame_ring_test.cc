@@ -0,0 +1,281 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "preview_frame_ring.h"
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "test_util.h"
+
+namespace {
+
+std::atomic<int> live_packets{0};
+std::atomic<int> double_destroys{0};
+
+}  // namespace
+
+// The fake packets are never freed, so that a second destroy is detected
+// instead of being undefined.
+struct media_packet_s {
+  int sequence;
+  bool has_surface;
+  std::atomic<bool> is_destroyed{false};
+};
+
+int media_packet_get_tbm_surface(media_packet_h packet,
+                                 tbm_surface_h *surface) {
+  if (!packet->has_surface) {
+    *surface = nullptr;
+    return MEDIA_PACKET_ERROR_INVALID_PARAMETER;
+  }
+  *surface = reinterpret_cast<tbm_surface_h>(packet);
+  return MEDIA_PACKET_ERROR_NONE;
+}
+
+int media_packet_destroy(media_packet_h packet) {
+  if (packet->is_destroyed.exchange(true)) {
+    double_destroys++;
+  } else {
+    live_packets--;
+  }
+  return MEDIA_PACKET_ERROR_NONE;
+}
+
+namespace {
+
+std::vector<std::unique_ptr<media_packet_s>> CreatePackets(int count) {
+  std::vector<std::unique_ptr<media_packet_s>> packets;
+  for (int i = 0; i < count; i++) {
+    auto packet = std::make_unique<media_packet_s>();
+    packet->sequence = i;
+    packet->has_surface = true;
+    packets.push_back(std::move(packet));
+  }
+  live_packets += count;
+  return packets;
+}
+
+int64_t GetStat(PreviewFrameRing &ring, const char *name) {
+  flutter::EncodableMap stats = ring.StatsToEncodableMap();
+  return std::get<int64_t>(stats[flutter::EncodableValue(name)]);
+}
+
+void TestPushAndPop() {
+  auto packets = CreatePackets(4);
+  PreviewFrameRing ring;
+  tbm_surface_h surface = nullptr;
+  EXPECT(ring.IsEmpty(), "a new ring is not empty");
+  EXPECT(ring.GetCapacity() == PreviewFrameRing::kDefaultCapacity,
+         "the capacity is %zu", ring.GetCapacity());
+  EXPECT(!ring.Pop(&surface), "an empty ring returned a packet");
+
+  EXPECT(ring.Push(packets[0].get()), "a push into an empty ring must notify");
+  EXPECT(!ring.Push(packets[1].get()), "a push behind a packet must not notify");
+  // The ring is full, so the oldest packet makes room.
+  EXPECT(!ring.Push(packets[2].get()), "a push behind a packet must not notify");
+  EXPECT(packets[0]->is_destroyed, "the oldest packet was not dropped");
+  EXPECT(ring.GetSize() == 2, "the size is %zu", ring.GetSize());
+
+  media_packet_h popped = ring.Pop(&surface);
+  EXPECT(popped == packets[1].get(), "the oldest packet was not popped");
+  EXPECT(surface == reinterpret_cast<tbm_surface_h>(popped),
+         "the surface of the packet was not returned");
+  media_packet_destroy(popped);
+  popped = ring.Pop(&surface);
+  EXPECT(popped == packets[2].get(), "the newest packet was not popped");
+  media_packet_destroy(popped);
+  EXPECT(ring.IsEmpty(), "the ring is not empty after popping all packets");
+
+  // A packet without a surface is dropped by the consumer.
+  packets[3]->has_surface = false;
+  EXPECT(ring.Push(packets[3].get()), "a push into an empty ring must notify");
+  EXPECT(!ring.Pop(&surface), "a packet without a surface was returned");
+  EXPECT(packets[3]->is_destroyed, "a packet without a surface leaked");
+
+  EXPECT(GetStat(ring, "produced") == 4, "produced is %lld",
+         static_cast<long long>(GetStat(ring, "produced")));
+  EXPECT(GetStat(ring, "presented") == 2, "presented is %lld",
+         static_cast<long long>(GetStat(ring, "presented")));
+  EXPECT(GetStat(ring, "dropped") == 2, "dropped is %lld",
+         static_cast<long long>(GetStat(ring, "dropped")));
+  ring.ResetStats();
+  EXPECT(GetStat(ring, "produced") == 0, "ResetStats() kept produced");
+}
+
+void TestDropNewest() {
+  auto packets = CreatePackets(3);
+  PreviewFrameRing ring(2, PreviewFrameDropPolicy::kDropNewest);
+  tbm_surface_h surface = nullptr;
+  ring.Push(packets[0].get());
+  ring.Push(packets[1].get());
+  EXPECT(!ring.Push(packets[2].get()), "a dropped push must not notify");
+  EXPECT(packets[2]->is_destroyed, "the pushed packet was not dropped");
+  EXPECT(!packets[0]->is_destroyed, "a queued packet was dropped");
+
+  media_packet_h popped = ring.Pop(&surface);
+  EXPECT(popped == packets[0].get(), "the oldest packet was not popped");
+  media_packet_destroy(popped);
+  popped = ring.Pop(&surface);
+  EXPECT(popped == packets[1].get(), "the second packet was not popped");
+  media_packet_destroy(popped);
+  EXPECT(GetStat(ring, "dropped") == 1, "dropped is %lld",
+         static_cast<long long>(GetStat(ring, "dropped")));
+}
+
+void TestSetCapacity() {
+  auto packets = CreatePackets(5);
+  PreviewFrameRing ring(4);
+  tbm_surface_h surface = nullptr;
+  for (int i = 0; i < 4; i++) {
+    ring.Push(packets[i].get());
+  }
+  // Shrinking keeps the queued packets until the next push.
+  ring.SetCapacity(2);
+  EXPECT(ring.GetSize() == 4, "the size is %zu", ring.GetSize());
+  ring.Push(packets[4].get());
+  EXPECT(ring.GetSize() == 2, "the size is %zu", ring.GetSize());
+  for (int i = 0; i < 3; i++) {
+    EXPECT(packets[i]->is_destroyed, "packet %d was not dropped", i);
+  }
+  for (int i = 3; i < 5; i++) {
+    media_packet_h popped = ring.Pop(&surface);
+    EXPECT(popped == packets[i].get(), "packet %d was not popped", i);
+    media_packet_destroy(popped);
+  }
+
+  ring.SetCapacity(0);
+  EXPECT(ring.GetCapacity() == 1, "the capacity is %zu", ring.GetCapacity());
+  ring.SetCapacity(100);
+  EXPECT(ring.GetCapacity() == PreviewFrameRing::kMaxCapacity,
+         "the capacity is %zu", ring.GetCapacity());
+  EXPECT(GetStat(ring, "capacity") == PreviewFrameRing::kMaxCapacity,
+         "the capacity stat is %lld",
+         static_cast<long long>(GetStat(ring, "capacity")));
+}
+
+void TestClear() {
+  auto packets = CreatePackets(2);
+  {
+    PreviewFrameRing ring;
+    ring.Push(packets[0].get());
+    ring.Push(packets[1].get());
+    ring.Clear();
+    EXPECT(packets[0]->is_destroyed && packets[1]->is_destroyed,
+           "Clear() did not destroy the packets");
+    EXPECT(ring.IsEmpty(), "the ring is not empty after Clear()");
+  }
+  packets = CreatePackets(1);
+  {
+    PreviewFrameRing ring;
+    ring.Push(packets[0].get());
+  }
+  EXPECT(packets[0]->is_destroyed, "the destructor did not destroy the packet");
+}
+
+// Runs a camera-like producer against a raster-like consumer: the consumer
+// only looks at the ring when notified, and holds each packet for a while
+// before releasing it, as the engine does with the texture. If
+// |vary_capacity| is set, the consumer also changes the capacity while the
+// producer runs.
+void TestProducerConsumer(size_t capacity, PreviewFrameDropPolicy drop_policy,
+                          bool vary_capacity) {
+  const int kPacketCount = 20000;
+  auto packets = CreatePackets(kPacketCount);
+  PreviewFrameRing ring(capacity, drop_policy);
+  std::atomic<bool> is_frame_available{false};
+  std::atomic<bool> is_producer_done{false};
+
+  std::thread producer([&]() {
+    for (int i = 0; i < kPacketCount; i++) {
+      if (ring.Push(packets[i].get())) {
+        is_frame_available.store(true, std::memory_order_release);
+      }
+      if (i % 64 == 0) {
+        std::this_thread::yield();
+      }
+    }
+    is_producer_done = true;
+  });
+
+  int last_sequence = -1;
+  int presented = 0;
+  bool is_ordered = true;
+  while (last_sequence != kPacketCount - 1) {
+    if (!is_frame_available.exchange(false, std::memory_order_acquire)) {
+      if (is_producer_done && ring.IsEmpty()) {
+        break;
+      }
+      std::this_thread::yield();
+      continue;
+    }
+    tbm_surface_h surface = nullptr;
+    media_packet_h packet = ring.Pop(&surface);
+    if (!packet) {
+      continue;
+    }
+    is_ordered = is_ordered && packet->sequence > last_sequence;
+    last_sequence = packet->sequence;
+    presented++;
+    if (presented % 16 == 0) {
+      std::this_thread::yield();
+    }
+    if (vary_capacity && presented % 100 == 0) {
+      ring.SetCapacity(1 + presented / 100 % PreviewFrameRing::kMaxCapacity);
+    }
+    // Releases the packet, then notifies again for a packet pushed while
+    // this one was held, as the release callback of the texture does.
+    media_packet_destroy(packet);
+    if (!ring.IsEmpty()) {
+      is_frame_available = true;
+    }
+  }
+  producer.join();
+
+  EXPECT(is_ordered, "packets were popped out of order");
+  if (drop_policy == PreviewFrameDropPolicy::kDropOldest) {
+    // The newest packet can never be missed.
+    EXPECT(last_sequence == kPacketCount - 1,
+           "the last packet popped is %d, expected %d", last_sequence,
+           kPacketCount - 1);
+  }
+  EXPECT(ring.IsEmpty(), "the ring is not empty at the end");
+  EXPECT(GetStat(ring, "produced") == kPacketCount, "produced is %lld",
+         static_cast<long long>(GetStat(ring, "produced")));
+  EXPECT(GetStat(ring, "presented") == presented, "presented is %lld",
+         static_cast<long long>(GetStat(ring, "presented")));
+  EXPECT(GetStat(ring, "presented") + GetStat(ring, "dropped") ==
+             kPacketCount,
+         "%lld presented and %lld dropped",
+         static_cast<long long>(GetStat(ring, "presented")),
+         static_cast<long long>(GetStat(ring, "dropped")));
+}
+
+}  // namespace
+
+int main() {
+  TestPushAndPop();
+  TestDropNewest();
+  TestSetCapacity();
+  TestClear();
+  const PreviewFrameDropPolicy kDropPolicies[] = {
+      PreviewFrameDropPolicy::kDropOldest, PreviewFrameDropPolicy::kDropNewest};
+  for (PreviewFrameDropPolicy drop_policy : kDropPolicies) {
+    for (size_t capacity : {1, 2, 8}) {
+      for (int i = 0; i < 5; i++) {
+        TestProducerConsumer(capacity, drop_policy, false);
+      }
+    }
+    for (int i = 0; i < 5; i++) {
+      TestProducerConsumer(2, drop_policy, true);
+    }
+  }
+  EXPECT(live_packets == 0, "%d packets leaked", live_packets.load());
+  EXPECT(double_destroys == 0, "%d packets destroyed twice",
+         double_destroys.load());
+  return ReportTestResult();
+}
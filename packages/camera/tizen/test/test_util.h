@@ -0,0 +1,39 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// The assertion helpers shared by the host tests.
+
+#ifndef TEST_UTIL_H_
+#define TEST_UTIL_H_
+
+#include <atomic>
+#include <cstdio>
+
+// The number of failed expectations. Atomic, so that any thread of a test
+// may report failures.
+inline std::atomic<int> failures{0};
+
+// Reports a failure with a printf-style message if |condition| is false, and
+// continues the test.
+#define EXPECT(condition, ...)                                       \
+  do {                                                               \
+    if (!(condition)) {                                              \
+      failures++;                                                    \
+      printf("%s:%d: %s failed: ", __FILE__, __LINE__, #condition); \
+      printf(__VA_ARGS__);                                           \
+      printf("\n");                                                  \
+    }                                                                \
+  } while (0)
+
+// Prints the result of the test. Returns the exit code of the test.
+inline int ReportTestResult() {
+  if (failures) {
+    printf("%d failure(s)\n", failures.load());
+    return 1;
+  }
+  printf("All tests passed\n");
+  return 0;
+}
+
+#endif  // TEST_UTIL_H_
@@ -0,0 +1,185 @@
+import 'dart:async';
+
+import 'package:flutter/services.dart';
+
+// Messages are encoded as positional lists holding the fields in the order
+// of the native message classes in tizen/src/message.h, which saves the
+// native side from hashing and comparing field names. A reply is [result] on
+// success and [code, message, details] on failure.
+
+/// A message identifying a player by its texture.
+class TextureMessage {
+  /// The texture ID of the player.
+  int? textureId;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[textureId];
+
+  /// Decodes a message encoded by [encode].
+  static TextureMessage decode(Object message) {
+    final List<Object?> fields = message as List<Object?>;
+    return TextureMessage()..textureId = fields[0] as int?;
+  }
+}
+
+/// A message describing the source of a new player.
+class CreateMessage {
+  /// The asset path, for an asset source.
+  String? asset;
+
+  /// The URI, for a network or file source.
+  String? uri;
+
+  /// The package of the asset, if any.
+  String? packageName;
+
+  /// The streaming format of a network source, if known.
+  String? formatHint;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[asset, uri, packageName, formatHint];
+}
+
+/// A message setting whether a player loops.
+class LoopingMessage {
+  /// The texture ID of the player.
+  int? textureId;
+
+  /// Whether the player loops.
+  bool? isLooping;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[textureId, isLooping];
+}
+
+/// A message setting the volume of a player.
+class VolumeMessage {
+  /// The texture ID of the player.
+  int? textureId;
+
+  /// The volume, from 0.0 to 1.0.
+  double? volume;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[textureId, volume];
+}
+
+/// A message setting the playback speed of a player.
+class PlaybackSpeedMessage {
+  /// The texture ID of the player.
+  int? textureId;
+
+  /// The playback speed, where 1.0 is the normal speed.
+  double? speed;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[textureId, speed];
+}
+
+/// A message holding the position of a player.
+class PositionMessage {
+  /// The texture ID of the player.
+  int? textureId;
+
+  /// The position in milliseconds.
+  int? position;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[textureId, position];
+
+  /// Decodes a message encoded by [encode].
+  static PositionMessage decode(Object message) {
+    final List<Object?> fields = message as List<Object?>;
+    return PositionMessage()
+      ..textureId = fields[0] as int?
+      ..position = fields[1] as int?;
+  }
+}
+
+/// A message setting whether the audio mixes with other apps.
+class MixWithOthersMessage {
+  /// Whether the audio mixes with other apps.
+  bool? mixWithOthers;
+
+  /// Encodes this message as a positional list.
+  Object encode() => <Object?>[mixWithOthers];
+}
+
+/// The API of the native plugin.
+class VideoPlayerApi {
+  /// Initializes the plugin and disposes all players.
+  Future<void> initialize() async {
+    await _send('initialize', <Object?>[]);
+  }
+
+  /// Creates a player and returns its texture.
+  Future<TextureMessage> create(CreateMessage arg) async {
+    return TextureMessage.decode((await _send('create', arg.encode()))!);
+  }
+
+  /// Disposes a player.
+  Future<void> dispose(TextureMessage arg) async {
+    await _send('dispose', arg.encode());
+  }
+
+  /// Sets whether a player loops.
+  Future<void> setLooping(LoopingMessage arg) async {
+    await _send('setLooping', arg.encode());
+  }
+
+  /// Sets the volume of a player.
+  Future<void> setVolume(VolumeMessage arg) async {
+    await _send('setVolume', arg.encode());
+  }
+
+  /// Sets the playback speed of a player.
+  Future<void> setPlaybackSpeed(PlaybackSpeedMessage arg) async {
+    await _send('setPlaybackSpeed', arg.encode());
+  }
+
+  /// Starts a player.
+  Future<void> play(TextureMessage arg) async {
+    await _send('play', arg.encode());
+  }
+
+  /// Returns the position of a player.
+  Future<PositionMessage> position(TextureMessage arg) async {
+    return PositionMessage.decode((await _send('position', arg.encode()))!);
+  }
+
+  /// Seeks a player and completes when the seek has completed.
+  Future<void> seekTo(PositionMessage arg) async {
+    await _send('seekTo', arg.encode());
+  }
+
+  /// Pauses a player.
+  Future<void> pause(TextureMessage arg) async {
+    await _send('pause', arg.encode());
+  }
+
+  /// Sets whether the audio mixes with other apps.
+  Future<void> setMixWithOthers(MixWithOthersMessage arg) async {
+    await _send('setMixWithOthers', arg.encode());
+  }
+
+  Future<Object?> _send(String method, Object message) async {
+    final BasicMessageChannel<Object?> channel = BasicMessageChannel<Object?>(
+        'dev.flutter.pigeon.VideoPlayerApi.$method',
+        const StandardMessageCodec());
+    final List<Object?>? reply = await channel.send(message) as List<Object?>?;
+    if (reply == null) {
+      throw PlatformException(
+        code: 'channel-error',
+        message: 'Unable to establish connection on channel.',
+      );
+    }
+    if (reply.length > 1) {
+      throw PlatformException(
+        code: reply[0]! as String,
+        message: reply[1] as String?,
+        details: reply[2],
+      );
+    }
+    return reply[0];
+  }
+}
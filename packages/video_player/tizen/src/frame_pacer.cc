@@ -0,0 +1,112 @@
+#include "frame_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "log.h"
+
+// The refresh interval is a moving average over about this many ticks.
+#define REFRESH_INTERVAL_SMOOTHING 16
+// A tick later than this many refresh intervals is a stall of the main loop
+// and is not measured.
+#define MAX_TICK_DELAY_RATIO 2.5
+
+FramePacer::~FramePacer() { Stop(); }
+
+void FramePacer::Start(FramePresentCb on_present) {
+  if (animator_) {
+    return;
+  }
+  on_present_ = std::move(on_present);
+  refresh_interval_ms_ = ecore_animator_frametime_get() * 1000;
+  last_tick_time_ = Clock::time_point();
+  tick_samples_ = 0;
+  last_present_vsync_ = 0;
+  phase_ms_ = 0;
+  animator_ = ecore_animator_add(OnAnimatorTick, this);
+  if (!animator_) {
+    LOG_ERROR("ecore_animator_add failed");
+    return;
+  }
+  is_running_ = true;
+}
+
+void FramePacer::Stop() {
+  is_running_ = false;
+  if (animator_) {
+    ecore_animator_del(animator_);
+    animator_ = nullptr;
+  }
+  on_present_ = nullptr;
+}
+
+void FramePacer::OnFramePresented() {
+  if (!is_running_) {
+    return;
+  }
+  uint64_t vsync = vsync_count_;
+  uint64_t last_vsync = last_present_vsync_.exchange(vsync);
+  double interval = frame_interval_ms_;
+  double refresh_interval = refresh_interval_ms_;
+  if (last_vsync == 0 || interval <= 0 || refresh_interval <= 0) {
+    return;
+  }
+  // A 24 fps frame on a 60 Hz display is due for 2.5 refreshes, so both 2
+  // and 3 are on cadence.
+  double expected = interval / refresh_interval;
+  uint64_t shown = vsync - last_vsync;
+  if (shown > std::ceil(expected)) {
+    frames_shown_longer_++;
+  } else if (shown < std::max(std::floor(expected), 1.0)) {
+    frames_shown_shorter_++;
+  }
+}
+
+void FramePacer::ResetStats() {
+  last_present_vsync_ = 0;
+  frames_shown_longer_ = 0;
+  frames_shown_shorter_ = 0;
+}
+
+void FramePacer::UpdateRefreshInterval() {
+  Clock::time_point now = Clock::now();
+  Clock::time_point last_tick_time = last_tick_time_;
+  last_tick_time_ = now;
+  if (last_tick_time == Clock::time_point()) {
+    return;
+  }
+  double tick_interval =
+      std::chrono::duration<double, std::milli>(now - last_tick_time).count();
+  double average = refresh_interval_ms_;
+  if (tick_samples_ >= REFRESH_INTERVAL_SMOOTHING &&
+      tick_interval > average * MAX_TICK_DELAY_RATIO) {
+    return;
+  }
+  // A plain mean until enough ticks are measured, so that a wrong seed is
+  // replaced quickly.
+  tick_samples_ = std::min(tick_samples_ + 1, REFRESH_INTERVAL_SMOOTHING);
+  refresh_interval_ms_ = average + (tick_interval - average) / tick_samples_;
+}
+
+Eina_Bool FramePacer::OnAnimatorTick(void *data) {
+  auto *self = static_cast<FramePacer *>(data);
+  self->vsync_count_++;
+  self->UpdateRefreshInterval();
+  double interval = self->frame_interval_ms_;
+  bool present = true;
+  if (interval > 0) {
+    self->phase_ms_ += self->refresh_interval_ms_;
+    present = self->phase_ms_ >= interval;
+    if (present) {
+      self->phase_ms_ -= interval;
+      if (self->phase_ms_ >= interval) {
+        // Catch up after a stall instead of presenting a burst of frames.
+        self->phase_ms_ = 0;
+      }
+    }
+  }
+  if (present && self->on_present_) {
+    self->on_present_();
+  }
+  return ECORE_CALLBACK_RENEW;
+}
@@ -0,0 +1,72 @@
+#ifndef FRAME_PACER_H_
+#define FRAME_PACER_H_
+
+#include <Ecore.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+using FramePresentCb = std::function<void()>;
+
+// Requests new video frames on display refresh (Ecore animator) ticks in a
+// regular pulldown cadence, e.g. 3:2 for 24 fps content on a 60 Hz display,
+// and counts the frames that stayed on screen for more or fewer refreshes
+// than the cadence allows.
+//
+// The animator may be driven by a timer rather than by the display, so the
+// refresh interval is measured from the ticks instead of being taken from
+// ecore_animator_frametime_get(), which only seeds the measurement.
+class FramePacer {
+ public:
+  FramePacer() = default;
+  ~FramePacer();
+
+  // Calls |on_present| on the main loop on every tick that should show a new
+  // frame.
+  void Start(FramePresentCb on_present);
+  void Stop();
+  // Can be called from any thread.
+  bool IsRunning() const { return is_running_; }
+
+  // The wall clock time between two content frames, i.e. the PTS interval
+  // divided by the playback speed. 0 means unknown, in which case every tick
+  // requests a frame. Can be called from any thread.
+  void SetFrameInterval(double interval_ms) {
+    frame_interval_ms_ = interval_ms;
+  }
+
+  // Must be called from the raster thread whenever a new frame is presented.
+  void OnFramePresented();
+
+  uint64_t GetFramesShownLonger() const { return frames_shown_longer_; }
+  uint64_t GetFramesShownShorter() const { return frames_shown_shorter_; }
+  void ResetStats();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  static Eina_Bool OnAnimatorTick(void *data);
+  void UpdateRefreshInterval();
+
+  // Only accessed by the main thread.
+  Ecore_Animator *animator_ = nullptr;
+  FramePresentCb on_present_;
+  double phase_ms_ = 0;
+  Clock::time_point last_tick_time_;
+  int tick_samples_ = 0;
+
+  std::atomic<bool> is_running_{false};
+  // Written by the main thread and read by the raster thread.
+  std::atomic<double> refresh_interval_ms_{0};
+  std::atomic<double> frame_interval_ms_{0};
+  std::atomic<uint64_t> vsync_count_{0};
+  std::atomic<uint64_t> frames_shown_longer_{0};
+  std::atomic<uint64_t> frames_shown_shorter_{0};
+  // Written by the raster thread. Cleared by the main thread, so that the
+  // first frame after Start() or ResetStats() is not measured.
+  std::atomic<uint64_t> last_present_vsync_{0};
+};
+
+#endif  // FRAME_PACER_H_
@@ -5,6 +5,107 @@
 
 #include "log.h"
 
+namespace {
+
+// Returns true if |message| is encoded in the positional layout.
+bool IsPositional(const flutter::EncodableValue &message) {
+  return std::holds_alternative<flutter::EncodableList>(message);
+}
+
+// Returns the field of |message| at |index| if the message is encoded as a
+// positional EncodableList, or the value of |key| if it is encoded as an
+// EncodableMap, without copying the message. Returns nullptr if there is no
+// such field.
+const flutter::EncodableValue *GetField(const flutter::EncodableValue &message,
+                                        size_t index, const char *key) {
+  if (auto *list = std::get_if<flutter::EncodableList>(&message)) {
+    return index < list->size() ? &(*list)[index] : nullptr;
+  }
+  if (auto *map = std::get_if<flutter::EncodableMap>(&message)) {
+    auto iter = map->find(flutter::EncodableValue(key));
+    return iter != map->end() ? &iter->second : nullptr;
+  }
+  return nullptr;
+}
+
+bool GetLongField(const flutter::EncodableValue &message, size_t index,
+                  const char *key, long &out) {
+  const flutter::EncodableValue *field = GetField(message, index, key);
+  if (field && (std::holds_alternative<int32_t>(*field) ||
+                std::holds_alternative<int64_t>(*field))) {
+    out = field->LongValue();
+    return true;
+  }
+  return false;
+}
+
+bool GetStringField(const flutter::EncodableValue &message, size_t index,
+                    const char *key, std::string &out) {
+  const flutter::EncodableValue *field = GetField(message, index, key);
+  if (field && std::holds_alternative<std::string>(*field)) {
+    out = std::get<std::string>(*field);
+    return true;
+  }
+  return false;
+}
+
+bool GetBoolField(const flutter::EncodableValue &message, size_t index,
+                  const char *key, bool &out) {
+  const flutter::EncodableValue *field = GetField(message, index, key);
+  if (field && std::holds_alternative<bool>(*field)) {
+    out = std::get<bool>(*field);
+    return true;
+  }
+  return false;
+}
+
+bool GetDoubleField(const flutter::EncodableValue &message, size_t index,
+                    const char *key, double &out) {
+  const flutter::EncodableValue *field = GetField(message, index, key);
+  if (field && std::holds_alternative<double>(*field)) {
+    out = std::get<double>(*field);
+    return true;
+  }
+  return false;
+}
+
+// Encodes |output| in the layout of |request|.
+template <typename T>
+flutter::EncodableValue Encode(const flutter::EncodableValue &request,
+                               T &output) {
+  return IsPositional(request) ? output.toList() : output.toMap();
+}
+
+// Wraps the result of a call in the layout of the request: [result] if
+// |positional|, {"result": result} otherwise.
+flutter::EncodableValue WrapResult(bool positional,
+                                   flutter::EncodableValue result) {
+  if (positional) {
+    return flutter::EncodableValue(flutter::EncodableList{std::move(result)});
+  }
+  flutter::EncodableMap wrapped = {
+      {flutter::EncodableValue("result"), std::move(result)}};
+  return flutter::EncodableValue(wrapped);
+}
+
+// Wraps |error| in the layout of the request: [code, message, details] if
+// |positional|, {"error": {"code": ..., "message": ..., "details": ...}}
+// otherwise.
+flutter::EncodableValue WrapError(bool positional,
+                                  const VideoPlayerError &error) {
+  if (positional) {
+    flutter::EncodableList wrapped = {
+        flutter::EncodableValue(error.getCode()),
+        flutter::EncodableValue(error.getMessage()), flutter::EncodableValue()};
+    return flutter::EncodableValue(wrapped);
+  }
+  flutter::EncodableMap wrapped = {
+      {flutter::EncodableValue("error"), VideoPlayerApi::wrapError(error)}};
+  return flutter::EncodableValue(wrapped);
+}
+
+}  // namespace
+
 long TextureMessage::getTextureId() const { return textureId_; }
 
 void TextureMessage::setTextureId(long textureId) { textureId_ = textureId; }
@@ -17,18 +118,19 @@ flutter::EncodableValue TextureMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue TextureMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)textureId_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 TextureMessage TextureMessage::fromMap(const flutter::EncodableValue &value) {
   TextureMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &textureId =
-        emap[flutter::EncodableValue("textureId")];
-    if (std::holds_alternative<int32_t>(textureId) ||
-        std::holds_alternative<int64_t>(textureId)) {
-      fromMapResult.setTextureId(textureId.LongValue());
-      LOG_DEBUG("[TextureMessage.fromMap] textureId: %ld",
-                fromMapResult.getTextureId());
-    }
+  long textureId;
+  if (GetLongField(value, 0, "textureId", textureId)) {
+    fromMapResult.setTextureId(textureId);
+    LOG_DEBUG("[TextureMessage.fromMap] textureId: %ld",
+              fromMapResult.getTextureId());
   }
   return fromMapResult;
 }
@@ -70,41 +172,41 @@ flutter::EncodableValue CreateMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue CreateMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue(asset_),
+      flutter::EncodableValue(uri_),
+      flutter::EncodableValue(packageName_),
+      flutter::EncodableValue(formatHint_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 CreateMessage CreateMessage::fromMap(const flutter::EncodableValue &value) {
   CreateMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &asset = emap[flutter::EncodableValue("asset")];
-    if (std::holds_alternative<std::string>(asset)) {
-      fromMapResult.setAsset(std::get<std::string>(asset));
-      LOG_DEBUG("[CreateMessage.fromMap] asset: %s",
-                fromMapResult.getAsset().c_str());
-    }
-
-    flutter::EncodableValue &uri = emap[flutter::EncodableValue("uri")];
-    if (std::holds_alternative<std::string>(uri)) {
-      fromMapResult.setUri(std::get<std::string>(uri));
-      LOG_DEBUG("[CreateMessage.fromMap] uri: %s",
-                fromMapResult.getUri().c_str());
-    }
-
-    flutter::EncodableValue &packageName =
-        emap[flutter::EncodableValue("packageName")];
-    if (std::holds_alternative<std::string>(packageName)) {
-      fromMapResult.setPackageName(std::get<std::string>(uri));
-      LOG_DEBUG("[CreateMessage.fromMap] packageName: %s",
-                fromMapResult.getPackageName().c_str());
-    }
-
-    flutter::EncodableValue &formatHint =
-        emap[flutter::EncodableValue("formatHint")];
-    if (std::holds_alternative<std::string>(formatHint)) {
-      fromMapResult.setFormatHint(std::get<std::string>(formatHint));
-      LOG_DEBUG("[CreateMessage.fromMap] formatHint: %s",
-                fromMapResult.getFormatHint().c_str());
-    }
+  std::string asset;
+  if (GetStringField(value, 0, "asset", asset)) {
+    fromMapResult.setAsset(asset);
+    LOG_DEBUG("[CreateMessage.fromMap] asset: %s",
+              fromMapResult.getAsset().c_str());
+  }
+  std::string uri;
+  if (GetStringField(value, 1, "uri", uri)) {
+    fromMapResult.setUri(uri);
+    LOG_DEBUG("[CreateMessage.fromMap] uri: %s",
+              fromMapResult.getUri().c_str());
+  }
+  std::string packageName;
+  if (GetStringField(value, 2, "packageName", packageName)) {
+    fromMapResult.setPackageName(packageName);
+    LOG_DEBUG("[CreateMessage.fromMap] packageName: %s",
+              fromMapResult.getPackageName().c_str());
+  }
+  std::string formatHint;
+  if (GetStringField(value, 3, "formatHint", formatHint)) {
+    fromMapResult.setFormatHint(formatHint);
+    LOG_DEBUG("[CreateMessage.fromMap] formatHint: %s",
+              fromMapResult.getFormatHint().c_str());
   }
-
   return fromMapResult;
 }
 
@@ -129,28 +231,27 @@ flutter::EncodableValue LoopingMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue LoopingMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)textureId_),
+      flutter::EncodableValue(isLooping_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 LoopingMessage LoopingMessage::fromMap(const flutter::EncodableValue &value) {
   LoopingMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &textureId =
-        emap[flutter::EncodableValue("textureId")];
-    if (std::holds_alternative<int32_t>(textureId) ||
-        std::holds_alternative<int64_t>(textureId)) {
-      fromMapResult.setTextureId(textureId.LongValue());
-      LOG_DEBUG("[LoopingMessage.fromMap] textureId: %ld",
-                fromMapResult.getTextureId());
-    }
-
-    flutter::EncodableValue &isLooping =
-        emap[flutter::EncodableValue("isLooping")];
-    if (std::holds_alternative<bool>(isLooping)) {
-      fromMapResult.setIsLooping(std::get<bool>(isLooping));
-      LOG_DEBUG("[LoopingMessage.fromMap] isLooping: %d",
-                fromMapResult.getIsLooping());
-    }
+  long textureId;
+  if (GetLongField(value, 0, "textureId", textureId)) {
+    fromMapResult.setTextureId(textureId);
+    LOG_DEBUG("[LoopingMessage.fromMap] textureId: %ld",
+              fromMapResult.getTextureId());
+  }
+  bool isLooping;
+  if (GetBoolField(value, 1, "isLooping", isLooping)) {
+    fromMapResult.setIsLooping(isLooping);
+    LOG_DEBUG("[LoopingMessage.fromMap] isLooping: %d",
+              fromMapResult.getIsLooping());
   }
-
   return fromMapResult;
 }
 
@@ -174,27 +275,26 @@ flutter::EncodableValue VolumeMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue VolumeMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)textureId_),
+      flutter::EncodableValue(volume_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 VolumeMessage VolumeMessage::fromMap(const flutter::EncodableValue &value) {
   VolumeMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &textureId =
-        emap[flutter::EncodableValue("textureId")];
-    if (std::holds_alternative<int32_t>(textureId) ||
-        std::holds_alternative<int64_t>(textureId)) {
-      fromMapResult.setTextureId(textureId.LongValue());
-      LOG_DEBUG("[VolumeMessage.fromMap] textureId: %ld",
-                fromMapResult.getTextureId());
-    }
-
-    flutter::EncodableValue &volume = emap[flutter::EncodableValue("volume")];
-    if (std::holds_alternative<double>(volume)) {
-      fromMapResult.setVolume(std::get<double>(volume));
-      LOG_DEBUG("[VolumeMessage.fromMap] volume: %f",
-                fromMapResult.getVolume());
-    }
+  long textureId;
+  if (GetLongField(value, 0, "textureId", textureId)) {
+    fromMapResult.setTextureId(textureId);
+    LOG_DEBUG("[VolumeMessage.fromMap] textureId: %ld",
+              fromMapResult.getTextureId());
+  }
+  double volume;
+  if (GetDoubleField(value, 1, "volume", volume)) {
+    fromMapResult.setVolume(volume);
+    LOG_DEBUG("[VolumeMessage.fromMap] volume: %f", fromMapResult.getVolume());
   }
-
   return fromMapResult;
 }
 
@@ -220,27 +320,28 @@ flutter::EncodableValue PlaybackSpeedMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue PlaybackSpeedMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)textureId_),
+      flutter::EncodableValue(speed_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 PlaybackSpeedMessage PlaybackSpeedMessage::fromMap(
     const flutter::EncodableValue &value) {
   PlaybackSpeedMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &textureId =
-        emap[flutter::EncodableValue("textureId")];
-    if (std::holds_alternative<int32_t>(textureId) ||
-        std::holds_alternative<int64_t>(textureId)) {
-      fromMapResult.setTextureId(textureId.LongValue());
-      LOG_DEBUG("[VolumeMessage.fromMap] textureId: %ld",
-                fromMapResult.getTextureId());
-    }
-
-    flutter::EncodableValue &speed = emap[flutter::EncodableValue("speed")];
-    if (std::holds_alternative<double>(speed)) {
-      fromMapResult.setSpeed(std::get<double>(speed));
-      LOG_DEBUG("[VolumeMessage.fromMap] speed: %f", fromMapResult.getSpeed());
-    }
+  long textureId;
+  if (GetLongField(value, 0, "textureId", textureId)) {
+    fromMapResult.setTextureId(textureId);
+    LOG_DEBUG("[PlaybackSpeedMessage.fromMap] textureId: %ld",
+              fromMapResult.getTextureId());
+  }
+  double speed;
+  if (GetDoubleField(value, 1, "speed", speed)) {
+    fromMapResult.setSpeed(speed);
+    LOG_DEBUG("[PlaybackSpeedMessage.fromMap] speed: %f",
+              fromMapResult.getSpeed());
   }
-
   return fromMapResult;
 }
 
@@ -265,29 +366,27 @@ flutter::EncodableValue PositionMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue PositionMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)textureId_),
+      flutter::EncodableValue((int64_t)position_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 PositionMessage PositionMessage::fromMap(const flutter::EncodableValue &value) {
   PositionMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &textureId =
-        emap[flutter::EncodableValue("textureId")];
-    if (std::holds_alternative<int32_t>(textureId) ||
-        std::holds_alternative<int64_t>(textureId)) {
-      fromMapResult.setTextureId(textureId.LongValue());
-      LOG_DEBUG("[PositionMessage.fromMap] textureId: %ld",
-                fromMapResult.getTextureId());
-    }
-
-    flutter::EncodableValue &position =
-        emap[flutter::EncodableValue("position")];
-    if (std::holds_alternative<int32_t>(position) ||
-        std::holds_alternative<int64_t>(position)) {
-      fromMapResult.setPosition(position.LongValue());
-      LOG_DEBUG("[PositionMessage.fromMap] position: %ld",
-                fromMapResult.getPosition());
-    }
+  long textureId;
+  if (GetLongField(value, 0, "textureId", textureId)) {
+    fromMapResult.setTextureId(textureId);
+    LOG_DEBUG("[PositionMessage.fromMap] textureId: %ld",
+              fromMapResult.getTextureId());
+  }
+  long position;
+  if (GetLongField(value, 1, "position", position)) {
+    fromMapResult.setPosition(position);
+    LOG_DEBUG("[PositionMessage.fromMap] position: %ld",
+              fromMapResult.getPosition());
   }
-
   return fromMapResult;
 }
 
@@ -307,20 +406,151 @@ flutter::EncodableValue MixWithOthersMessage::toMap() {
   return flutter::EncodableValue(toMapResult);
 }
 
+flutter::EncodableValue MixWithOthersMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue(mixWithOthers_)};
+  return flutter::EncodableValue(toListResult);
+}
+
 MixWithOthersMessage MixWithOthersMessage::fromMap(
     const flutter::EncodableValue &value) {
   MixWithOthersMessage fromMapResult;
-  if (std::holds_alternative<flutter::EncodableMap>(value)) {
-    flutter::EncodableMap emap = std::get<flutter::EncodableMap>(value);
-    flutter::EncodableValue &mixWithOthers =
-        emap[flutter::EncodableValue("mixWithOthers")];
-    if (std::holds_alternative<bool>(mixWithOthers)) {
-      fromMapResult.setMixWithOthers(std::get<bool>(mixWithOthers));
-      LOG_DEBUG("[MixWithOthersMessage.fromMap] mixWithOthers: %d",
-                fromMapResult.getMixWithOthers());
-    }
+  bool mixWithOthers;
+  if (GetBoolField(value, 0, "mixWithOthers", mixWithOthers)) {
+    fromMapResult.setMixWithOthers(mixWithOthers);
+    LOG_DEBUG("[MixWithOthersMessage.fromMap] mixWithOthers: %d",
+              fromMapResult.getMixWithOthers());
+  }
+  return fromMapResult;
+}
+
+long PreloadLimitMessage::getMaxPreloadedPlayers() const {
+  return maxPreloadedPlayers_;
+}
+
+void PreloadLimitMessage::setMaxPreloadedPlayers(long maxPreloadedPlayers) {
+  maxPreloadedPlayers_ = maxPreloadedPlayers;
+}
+
+flutter::EncodableValue PreloadLimitMessage::toMap() {
+  LOG_DEBUG("[PreloadLimitMessage.toMap] maxPreloadedPlayers: %ld",
+            maxPreloadedPlayers_);
+
+  flutter::EncodableMap toMapResult = {
+      {flutter::EncodableValue("maxPreloadedPlayers"),
+       flutter::EncodableValue((int64_t)maxPreloadedPlayers_)}};
+
+  return flutter::EncodableValue(toMapResult);
+}
+
+flutter::EncodableValue PreloadLimitMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)maxPreloadedPlayers_)};
+  return flutter::EncodableValue(toListResult);
+}
+
+PreloadLimitMessage PreloadLimitMessage::fromMap(
+    const flutter::EncodableValue &value) {
+  PreloadLimitMessage fromMapResult;
+  long maxPreloadedPlayers;
+  if (GetLongField(value, 0, "maxPreloadedPlayers", maxPreloadedPlayers)) {
+    fromMapResult.setMaxPreloadedPlayers(maxPreloadedPlayers);
+    LOG_DEBUG("[PreloadLimitMessage.fromMap] maxPreloadedPlayers: %ld",
+              fromMapResult.getMaxPreloadedPlayers());
+  }
+  return fromMapResult;
+}
+
+long PlaybackStatsIntervalMessage::getIntervalMs() const {
+  return intervalMs_;
+}
+
+void PlaybackStatsIntervalMessage::setIntervalMs(long intervalMs) {
+  intervalMs_ = intervalMs;
+}
+
+flutter::EncodableValue PlaybackStatsIntervalMessage::toMap() {
+  LOG_DEBUG("[PlaybackStatsIntervalMessage.toMap] intervalMs: %ld",
+            intervalMs_);
+
+  flutter::EncodableMap toMapResult = {
+      {flutter::EncodableValue("intervalMs"),
+       flutter::EncodableValue((int64_t)intervalMs_)}};
+
+  return flutter::EncodableValue(toMapResult);
+}
+
+flutter::EncodableValue PlaybackStatsIntervalMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)intervalMs_)};
+  return flutter::EncodableValue(toListResult);
+}
+
+PlaybackStatsIntervalMessage PlaybackStatsIntervalMessage::fromMap(
+    const flutter::EncodableValue &value) {
+  PlaybackStatsIntervalMessage fromMapResult;
+  long intervalMs;
+  if (GetLongField(value, 0, "intervalMs", intervalMs)) {
+    fromMapResult.setIntervalMs(intervalMs);
+    LOG_DEBUG("[PlaybackStatsIntervalMessage.fromMap] intervalMs: %ld",
+              fromMapResult.getIntervalMs());
   }
+  return fromMapResult;
+}
+
+long BufferingThrottleMessage::getMinIntervalMs() const {
+  return minIntervalMs_;
+}
+
+void BufferingThrottleMessage::setMinIntervalMs(long minIntervalMs) {
+  minIntervalMs_ = minIntervalMs;
+}
+
+long BufferingThrottleMessage::getMinPercentDelta() const {
+  return minPercentDelta_;
+}
+
+void BufferingThrottleMessage::setMinPercentDelta(long minPercentDelta) {
+  minPercentDelta_ = minPercentDelta;
+}
+
+flutter::EncodableValue BufferingThrottleMessage::toMap() {
+  LOG_DEBUG("[BufferingThrottleMessage.toMap] minIntervalMs: %ld",
+            minIntervalMs_);
+  LOG_DEBUG("[BufferingThrottleMessage.toMap] minPercentDelta: %ld",
+            minPercentDelta_);
+
+  flutter::EncodableMap toMapResult = {
+      {flutter::EncodableValue("minIntervalMs"),
+       flutter::EncodableValue((int64_t)minIntervalMs_)},
+      {flutter::EncodableValue("minPercentDelta"),
+       flutter::EncodableValue((int64_t)minPercentDelta_)}};
+
+  return flutter::EncodableValue(toMapResult);
+}
+
+flutter::EncodableValue BufferingThrottleMessage::toList() {
+  flutter::EncodableList toListResult = {
+      flutter::EncodableValue((int64_t)minIntervalMs_),
+      flutter::EncodableValue((int64_t)minPercentDelta_)};
+  return flutter::EncodableValue(toListResult);
+}
 
+BufferingThrottleMessage BufferingThrottleMessage::fromMap(
+    const flutter::EncodableValue &value) {
+  BufferingThrottleMessage fromMapResult;
+  long minIntervalMs;
+  if (GetLongField(value, 0, "minIntervalMs", minIntervalMs)) {
+    fromMapResult.setMinIntervalMs(minIntervalMs);
+    LOG_DEBUG("[BufferingThrottleMessage.fromMap] minIntervalMs: %ld",
+              fromMapResult.getMinIntervalMs());
+  }
+  long minPercentDelta;
+  if (GetLongField(value, 1, "minPercentDelta", minPercentDelta)) {
+    fromMapResult.setMinPercentDelta(minPercentDelta);
+    LOG_DEBUG("[BufferingThrottleMessage.fromMap] minPercentDelta: %ld",
+              fromMapResult.getMinPercentDelta());
+  }
   return fromMapResult;
 }
 
@@ -335,16 +565,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
     initChannel->SetMessageHandler(
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
-          flutter::EncodableMap wrapped;
           try {
             api->initialize();
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -358,15 +584,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           CreateMessage input = CreateMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             TextureMessage output = api->create(input);
-            wrapped.emplace(flutter::EncodableValue("result"), output.toMap());
+            reply(WrapResult(IsPositional(message), Encode(message, output)));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -380,16 +603,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           TextureMessage input = TextureMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->dispose(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -403,16 +622,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           LoopingMessage input = LoopingMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->setLooping(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -426,16 +641,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           VolumeMessage input = VolumeMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->setVolume(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -449,16 +660,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           PlaybackSpeedMessage input = PlaybackSpeedMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->setPlaybackSpeed(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -472,16 +679,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           TextureMessage input = TextureMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->play(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -495,15 +698,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           TextureMessage input = TextureMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             PositionMessage output = api->position(input);
-            wrapped.emplace(flutter::EncodableValue("result"), output.toMap());
+            reply(WrapResult(IsPositional(message), Encode(message, output)));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -518,16 +718,11 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           PositionMessage input = PositionMessage::fromMap(message);
           try {
-            api->seekTo(input, [reply]() {
-              flutter::EncodableMap wrapped = {
-                  {flutter::EncodableValue("result"),
-                   flutter::EncodableValue()}};
-              reply(flutter::EncodableValue(wrapped));
+            api->seekTo(input, [reply, positional = IsPositional(message)]() {
+              reply(WrapResult(positional, flutter::EncodableValue()));
             });
           } catch (const VideoPlayerError &e) {
-            flutter::EncodableMap error = {{flutter::EncodableValue("error"),
-                                            VideoPlayerApi::wrapError(e)}};
-            reply(flutter::EncodableValue(error));
+            reply(WrapError(IsPositional(message), e));
           }
         });
   }
@@ -542,16 +737,12 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           TextureMessage input = TextureMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->pause(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 
@@ -565,16 +756,93 @@ void VideoPlayerApi::setup(flutter::BinaryMessenger *binaryMessenger,
         [api](const flutter::EncodableValue &message,
               flutter::MessageReply<flutter::EncodableValue> reply) {
           MixWithOthersMessage input = MixWithOthersMessage::fromMap(message);
-          flutter::EncodableMap wrapped;
           try {
             api->setMixWithOthers(input);
-            wrapped.emplace(flutter::EncodableValue("result"),
-                            flutter::EncodableValue());
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
+          } catch (const VideoPlayerError &e) {
+            reply(WrapError(IsPositional(message), e));
+          }
+        });
+  }
+
+  LOG_DEBUG("[VideoPlayerApi.setup] setup preload channel");
+  auto preloadChannel =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          binaryMessenger, "dev.flutter.pigeon.VideoPlayerApi.preload",
+          &flutter::StandardMessageCodec::GetInstance());
+  if (api != nullptr) {
+    preloadChannel->SetMessageHandler(
+        [api](const flutter::EncodableValue &message,
+              flutter::MessageReply<flutter::EncodableValue> reply) {
+          CreateMessage input = CreateMessage::fromMap(message);
+          try {
+            api->preload(input);
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
+          } catch (const VideoPlayerError &e) {
+            reply(WrapError(IsPositional(message), e));
+          }
+        });
+  }
+
+  LOG_DEBUG("[VideoPlayerApi.setup] setup setMaxPreloadedPlayers channel");
+  auto preloadLimitChannel =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          binaryMessenger,
+          "dev.flutter.pigeon.VideoPlayerApi.setMaxPreloadedPlayers",
+          &flutter::StandardMessageCodec::GetInstance());
+  if (api != nullptr) {
+    preloadLimitChannel->SetMessageHandler(
+        [api](const flutter::EncodableValue &message,
+              flutter::MessageReply<flutter::EncodableValue> reply) {
+          PreloadLimitMessage input = PreloadLimitMessage::fromMap(message);
+          try {
+            api->setMaxPreloadedPlayers(input);
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
+          } catch (const VideoPlayerError &e) {
+            reply(WrapError(IsPositional(message), e));
+          }
+        });
+  }
+
+  LOG_DEBUG("[VideoPlayerApi.setup] setup setPlaybackStatsInterval channel");
+  auto statsIntervalChannel =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          binaryMessenger,
+          "dev.flutter.pigeon.VideoPlayerApi.setPlaybackStatsInterval",
+          &flutter::StandardMessageCodec::GetInstance());
+  if (api != nullptr) {
+    statsIntervalChannel->SetMessageHandler(
+        [api](const flutter::EncodableValue &message,
+              flutter::MessageReply<flutter::EncodableValue> reply) {
+          PlaybackStatsIntervalMessage input =
+              PlaybackStatsIntervalMessage::fromMap(message);
+          try {
+            api->setPlaybackStatsInterval(input);
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
+          } catch (const VideoPlayerError &e) {
+            reply(WrapError(IsPositional(message), e));
+          }
+        });
+  }
+
+  LOG_DEBUG("[VideoPlayerApi.setup] setup setBufferingThrottle channel");
+  auto bufferingThrottleChannel =
+      std::make_unique<flutter::BasicMessageChannel<flutter::EncodableValue>>(
+          binaryMessenger,
+          "dev.flutter.pigeon.VideoPlayerApi.setBufferingThrottle",
+          &flutter::StandardMessageCodec::GetInstance());
+  if (api != nullptr) {
+    bufferingThrottleChannel->SetMessageHandler(
+        [api](const flutter::EncodableValue &message,
+              flutter::MessageReply<flutter::EncodableValue> reply) {
+          BufferingThrottleMessage input =
+              BufferingThrottleMessage::fromMap(message);
+          try {
+            api->setBufferingThrottle(input);
+            reply(WrapResult(IsPositional(message), flutter::EncodableValue()));
           } catch (const VideoPlayerError &e) {
-            wrapped.emplace(flutter::EncodableValue("error"),
-                            VideoPlayerApi::wrapError(e));
+            reply(WrapError(IsPositional(message), e));
           }
-          reply(flutter::EncodableValue(wrapped));
         });
   }
 }
@@ -9,6 +9,12 @@
 
 #include "video_player_error.h"
 
+// Each message is encoded either as an EncodableMap keyed by field name, as
+// sent by the video_player platform interface, or as a positional
+// EncodableList holding the fields in declaration order, as sent by the Dart
+// side of this package, which avoids hashing and comparing keys. fromMap()
+// accepts both, and replies use the layout of the request.
+
 class TextureMessage {
  public:
   TextureMessage() : textureId_(0) {}
@@ -19,6 +25,7 @@ class TextureMessage {
   long getTextureId() const;
   void setTextureId(long textureId);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static TextureMessage fromMap(const flutter::EncodableValue &value);
 
  private:
@@ -41,6 +48,7 @@ class CreateMessage {
   std::string getFormatHint() const;
   void setFormatHint(const std::string &formatHint);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static CreateMessage fromMap(const flutter::EncodableValue &value);
 
  private:
@@ -62,6 +70,7 @@ class LoopingMessage {
   bool getIsLooping() const;
   void setIsLooping(bool isLooping);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static LoopingMessage fromMap(const flutter::EncodableValue &value);
 
  private:
@@ -81,6 +90,7 @@ class VolumeMessage {
   double getVolume() const;
   void setVolume(double volume);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static VolumeMessage fromMap(const flutter::EncodableValue &value);
 
  private:
@@ -100,6 +110,7 @@ class PlaybackSpeedMessage {
   double getSpeed() const;
   void setSpeed(double speed);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static PlaybackSpeedMessage fromMap(const flutter::EncodableValue &value);
 
  private:
@@ -119,6 +130,7 @@ class PositionMessage {
   long getPosition() const;
   void setPosition(long position);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static PositionMessage fromMap(const flutter::EncodableValue &value);
 
  private:
@@ -136,12 +148,70 @@ class MixWithOthersMessage {
   bool getMixWithOthers() const;
   void setMixWithOthers(bool mixWithOthers);
   flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
   static MixWithOthersMessage fromMap(const flutter::EncodableValue &value);
 
  private:
   bool mixWithOthers_;
 };
 
+class PreloadLimitMessage {
+ public:
+  PreloadLimitMessage() : maxPreloadedPlayers_(0) {}
+  ~PreloadLimitMessage() = default;
+  PreloadLimitMessage(PreloadLimitMessage const &) = default;
+  PreloadLimitMessage &operator=(PreloadLimitMessage const &) = default;
+
+  long getMaxPreloadedPlayers() const;
+  void setMaxPreloadedPlayers(long maxPreloadedPlayers);
+  flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
+  static PreloadLimitMessage fromMap(const flutter::EncodableValue &value);
+
+ private:
+  long maxPreloadedPlayers_;
+};
+
+class PlaybackStatsIntervalMessage {
+ public:
+  PlaybackStatsIntervalMessage() : intervalMs_(0) {}
+  ~PlaybackStatsIntervalMessage() = default;
+  PlaybackStatsIntervalMessage(PlaybackStatsIntervalMessage const &) = default;
+  PlaybackStatsIntervalMessage &operator=(
+      PlaybackStatsIntervalMessage const &) = default;
+
+  long getIntervalMs() const;
+  void setIntervalMs(long intervalMs);
+  flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
+  static PlaybackStatsIntervalMessage fromMap(
+      const flutter::EncodableValue &value);
+
+ private:
+  long intervalMs_;
+};
+
+class BufferingThrottleMessage {
+ public:
+  BufferingThrottleMessage() : minIntervalMs_(0), minPercentDelta_(0) {}
+  ~BufferingThrottleMessage() = default;
+  BufferingThrottleMessage(BufferingThrottleMessage const &) = default;
+  BufferingThrottleMessage &operator=(BufferingThrottleMessage const &) =
+      default;
+
+  long getMinIntervalMs() const;
+  void setMinIntervalMs(long minIntervalMs);
+  long getMinPercentDelta() const;
+  void setMinPercentDelta(long minPercentDelta);
+  flutter::EncodableValue toMap();
+  flutter::EncodableValue toList();
+  static BufferingThrottleMessage fromMap(const flutter::EncodableValue &value);
+
+ private:
+  long minIntervalMs_;
+  long minPercentDelta_;
+};
+
 using SeekCompletedCb = std::function<void()>;
 
 class VideoPlayerApi {
@@ -159,6 +229,13 @@ class VideoPlayerApi {
                       const SeekCompletedCb &onSeekCompleted) = 0;
   virtual void setMixWithOthers(
       const MixWithOthersMessage &mixWithOthersMsg) = 0;
+  virtual void preload(const CreateMessage &createMsg) = 0;
+  virtual void setMaxPreloadedPlayers(
+      const PreloadLimitMessage &preloadLimitMsg) = 0;
+  virtual void setPlaybackStatsInterval(
+      const PlaybackStatsIntervalMessage &intervalMsg) = 0;
+  virtual void setBufferingThrottle(
+      const BufferingThrottleMessage &throttleMsg) = 0;
 
   static void setup(flutter::BinaryMessenger *binaryMessenger,
                     VideoPlayerApi *api);
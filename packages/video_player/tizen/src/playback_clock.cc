@@ -0,0 +1,59 @@
+#include "playback_clock.h"
+
+void PlaybackClock::Sync(int64_t position_ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  anchor_position_ms_ = position_ms;
+  anchor_time_ = sync_time_ = Clock::now();
+}
+
+void PlaybackClock::SetRunning(bool is_running) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Rebase(Clock::now());
+  is_running_ = is_running;
+}
+
+void PlaybackClock::SetSpeed(double speed) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Rebase(Clock::now());
+  speed_ = speed;
+}
+
+void PlaybackClock::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  anchor_position_ms_ = -1;
+  speed_ = 1.0;
+  is_running_ = false;
+}
+
+bool PlaybackClock::IsRunning() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return is_running_;
+}
+
+int64_t PlaybackClock::GetPositionMs() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Extrapolate(Clock::now());
+}
+
+int64_t PlaybackClock::GetMsSinceSync() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (anchor_position_ms_ < 0) {
+    return -1;
+  }
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                               sync_time_)
+      .count();
+}
+
+void PlaybackClock::Rebase(Clock::time_point now) {
+  anchor_position_ms_ = Extrapolate(now);
+  anchor_time_ = now;
+}
+
+int64_t PlaybackClock::Extrapolate(Clock::time_point now) const {
+  if (anchor_position_ms_ < 0 || !is_running_) {
+    return anchor_position_ms_;
+  }
+  std::chrono::duration<double, std::milli> elapsed = now - anchor_time_;
+  return anchor_position_ms_ + static_cast<int64_t>(elapsed.count() * speed_);
+}
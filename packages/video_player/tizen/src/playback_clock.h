@@ -0,0 +1,47 @@
+#ifndef PLAYBACK_CLOCK_H_
+#define PLAYBACK_CLOCK_H_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Extrapolates the playback position from the last position read from the
+// player, so that the raster thread never has to query the player, which is
+// an IPC call, to know which frame is due. All methods are thread-safe and
+// only do arithmetic under the lock.
+class PlaybackClock {
+ public:
+  PlaybackClock() = default;
+  ~PlaybackClock() = default;
+
+  // Sets the position to |position_ms| as of now.
+  void Sync(int64_t position_ms);
+  // The position advances only while running, at |speed| times real time.
+  void SetRunning(bool is_running);
+  void SetSpeed(double speed);
+  // Makes the position unknown until the next Sync().
+  void Reset();
+
+  bool IsRunning();
+
+  // Returns the extrapolated position, or -1 if unknown.
+  int64_t GetPositionMs();
+  // Returns the time since the last Sync(), or -1 if never synced.
+  int64_t GetMsSinceSync();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // Moves the anchor to now. Must be called with |mutex_| held.
+  void Rebase(Clock::time_point now);
+  int64_t Extrapolate(Clock::time_point now) const;
+
+  std::mutex mutex_;
+  int64_t anchor_position_ms_ = -1;
+  Clock::time_point anchor_time_;
+  Clock::time_point sync_time_;
+  double speed_ = 1.0;
+  bool is_running_ = false;
+};
+
+#endif  // PLAYBACK_CLOCK_H_
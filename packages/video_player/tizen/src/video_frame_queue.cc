@@ -0,0 +1,117 @@
+#include "video_frame_queue.h"
+
+#include <cmath>
+
+#include "log.h"
+
+// A frame is due if its PTS is within this fraction of a frame interval from
+// the clock, which absorbs the jitter of the clock readings.
+#define DUE_TOLERANCE_DIVISOR 2
+#define DEFAULT_FRAME_INTERVAL_MS 16
+// A gap between the clock and the next frame larger than this is treated as
+// a clock discontinuity rather than as an early frame.
+#define MAX_CLOCK_GAP_MS 1000
+// The frame interval is a moving average over about this many frames, so that
+// PTS rounded to milliseconds (e.g. 41 and 42 ms at 24 fps) give a steady
+// interval.
+#define FRAME_INTERVAL_SMOOTHING 8
+// An interval that differs from the average by more than this fraction is a
+// frame rate change and replaces the average.
+#define FRAME_INTERVAL_CHANGE_RATIO 0.1
+
+VideoFrameQueue::VideoFrameQueue(size_t capacity) : capacity_(capacity) {}
+
+VideoFrameQueue::~VideoFrameQueue() {
+  while (!frames_.empty()) {
+    media_packet_destroy(frames_.front().packet);
+    frames_.pop_front();
+  }
+}
+
+bool VideoFrameQueue::Push(media_packet_h packet) {
+  stats_.decoded++;
+  uint64_t pts = 0;
+  int ret = media_packet_get_pts(packet, &pts);
+  if (ret != MEDIA_PACKET_ERROR_NONE) {
+    LOG_ERROR("media_packet_get_pts failed, error: %d", ret);
+  }
+  int64_t pts_us = static_cast<int64_t>(pts / 1000);
+  int64_t pts_ms = pts_us / 1000;
+
+  // Compared with the last pushed frame rather than the last queued one, so
+  // that a discontinuity is also detected when the queue has been drained.
+  bool is_discontinuity = false;
+  if (last_pts_us_ >= 0) {
+    if (pts_us < last_pts_us_) {
+      LOG_INFO("PTS discontinuity: %lld -> %lld",
+               (long long)(last_pts_us_ / 1000), (long long)pts_ms);
+      is_discontinuity = true;
+      while (!frames_.empty()) {
+        DropFront();
+      }
+    } else if (pts_us > last_pts_us_) {
+      UpdateFrameInterval((pts_us - last_pts_us_) / 1000.0);
+    }
+  }
+  last_pts_us_ = pts_us;
+  if (frames_.size() >= capacity_) {
+    DropFront();
+  }
+  frames_.push_back({packet, pts_ms});
+  return is_discontinuity;
+}
+
+media_packet_h VideoFrameQueue::Pop(int64_t clock_ms) {
+  if (frames_.empty()) {
+    return nullptr;
+  }
+
+  int64_t interval = frame_interval_ms_ > 0
+                         ? static_cast<int64_t>(frame_interval_ms_)
+                         : DEFAULT_FRAME_INTERVAL_MS;
+  int64_t due_ms = clock_ms + interval / DUE_TOLERANCE_DIVISOR;
+  bool present_newest = clock_ms < 0;
+  if (needs_resync_ ||
+      frames_.front().pts_ms > clock_ms + MAX_CLOCK_GAP_MS) {
+    // Nothing was presented since the last flush, or the clock jumped. Show
+    // the oldest frame now rather than waiting for the clock.
+    needs_resync_ = false;
+    due_ms = frames_.front().pts_ms;
+  }
+  if (!present_newest && frames_.front().pts_ms > due_ms) {
+    return nullptr;
+  }
+
+  while (frames_.size() > 1 &&
+         (present_newest || frames_[1].pts_ms <= due_ms)) {
+    DropFront();
+  }
+  media_packet_h packet = frames_.front().packet;
+  frames_.pop_front();
+  return packet;
+}
+
+void VideoFrameQueue::Flush() {
+  while (!frames_.empty()) {
+    DropFront();
+  }
+  last_pts_us_ = -1;
+  needs_resync_ = true;
+}
+
+void VideoFrameQueue::UpdateFrameInterval(double interval_ms) {
+  if (frame_interval_ms_ <= 0 ||
+      std::abs(interval_ms - frame_interval_ms_) >
+          frame_interval_ms_ * FRAME_INTERVAL_CHANGE_RATIO) {
+    frame_interval_ms_ = interval_ms;
+    return;
+  }
+  frame_interval_ms_ +=
+      (interval_ms - frame_interval_ms_) / FRAME_INTERVAL_SMOOTHING;
+}
+
+void VideoFrameQueue::DropFront() {
+  media_packet_destroy(frames_.front().packet);
+  frames_.pop_front();
+  stats_.dropped++;
+}
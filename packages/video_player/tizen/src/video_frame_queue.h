@@ -0,0 +1,74 @@
+#ifndef VIDEO_FRAME_QUEUE_H_
+#define VIDEO_FRAME_QUEUE_H_
+
+#include <media_packet.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+struct VideoFrameStats {
+  uint64_t decoded = 0;
+  uint64_t rendered = 0;
+  // Frames that were never presented, either because a newer frame was due
+  // at the same time or because the queue was full.
+  uint64_t dropped = 0;
+  // Presentations that repeated the previous frame because no new frame was
+  // due yet.
+  uint64_t duplicated = 0;
+};
+
+// Holds decoded video frames in presentation timestamp (PTS) order until they
+// are due on the playback clock. This class is not thread-safe.
+class VideoFrameQueue {
+ public:
+  explicit VideoFrameQueue(size_t capacity);
+  ~VideoFrameQueue();
+
+  // Takes the ownership of |packet|. If the queue is full, the oldest frame
+  // is dropped. A PTS lower than that of the last queued frame (e.g. when
+  // looping) is a discontinuity and drops all queued frames. Returns true on
+  // a discontinuity.
+  bool Push(media_packet_h packet);
+
+  // Returns the newest frame whose PTS is not later than |clock_ms| and
+  // passes its ownership to the caller. Older frames are dropped as late.
+  // Returns nullptr if no frame is due yet. A negative |clock_ms| means the
+  // clock is unknown, in which case the newest frame is returned.
+  media_packet_h Pop(int64_t clock_ms);
+
+  // Drops all queued frames, e.g. on seek. The next Pop() returns the first
+  // frame pushed after this call regardless of the clock.
+  void Flush();
+
+  bool IsEmpty() const { return frames_.empty(); }
+  // The PTS of the last pushed frame, or -1 if none since the last flush.
+  int64_t GetLastPtsMs() const {
+    return last_pts_us_ < 0 ? -1 : last_pts_us_ / 1000;
+  }
+  // The average PTS interval of recent frames, or 0 if unknown.
+  double GetFrameIntervalMs() const { return frame_interval_ms_; }
+
+  void CountRendered() { stats_.rendered++; }
+  void CountDuplicated() { stats_.duplicated++; }
+  const VideoFrameStats &GetStats() const { return stats_; }
+  void ResetStats() { stats_ = VideoFrameStats(); }
+
+ private:
+  struct Frame {
+    media_packet_h packet;
+    int64_t pts_ms;
+  };
+
+  void DropFront();
+  void UpdateFrameInterval(double interval_ms);
+
+  size_t capacity_;
+  std::deque<Frame> frames_;
+  int64_t last_pts_us_ = -1;
+  double frame_interval_ms_ = 0;
+  bool needs_resync_ = true;
+  VideoFrameStats stats_;
+};
+
+#endif  // VIDEO_FRAME_QUEUE_H_
@@ -3,11 +3,19 @@
 #include <flutter/event_stream_handler_functions.h>
 #include <flutter/standard_method_codec.h>
 
+#include <cstdlib>
 #include <functional>
 
 #include "log.h"
 #include "video_player_error.h"
 
+// The number of decoded frames held until they are due. The decoder stalls if
+// too many of its output buffers are held.
+#define FRAME_QUEUE_CAPACITY 3
+// The playback clock is extrapolated between reads of the player position at
+// least this far apart.
+#define CLOCK_SYNC_INTERVAL_MS 250
+
 static std::string RotationToString(player_display_rotation_e rotation) {
   std::string ret;
   switch (rotation) {
@@ -61,23 +69,38 @@ bool VideoPlayer::IsValidMediaPacket(media_packet_h media_packet) {
 
 FlutterDesktopGpuBuffer *VideoPlayer::ObtainGpuBuffer(size_t width,
                                                       size_t height) {
+  int64_t clock_ms = playback_clock_.GetPositionMs();
+  bool is_clock_running = playback_clock_.IsRunning();
   std::lock_guard<std::mutex> lock(mutex_);
-  if (prepared_media_packet_ && !IsValidMediaPacket(prepared_media_packet_)) {
-    media_packet_destroy(prepared_media_packet_);
-    prepared_media_packet_ = nullptr;
-  }
-  if (current_media_packet_ && !IsValidMediaPacket(current_media_packet_)) {
-    media_packet_destroy(current_media_packet_);
-    current_media_packet_ = nullptr;
+  if (!is_current_media_packet_in_use_) {
+    media_packet_h packet = frame_queue_.Pop(clock_ms);
+    if (packet && !IsValidMediaPacket(packet)) {
+      media_packet_destroy(packet);
+      packet = nullptr;
+    }
+    if (packet) {
+      if (current_media_packet_) {
+        media_packet_destroy(current_media_packet_);
+      }
+      current_media_packet_ = packet;
+      frame_queue_.CountRendered();
+      frame_pacer_.OnFramePresented();
+    } else if (current_media_packet_) {
+      frame_queue_.CountDuplicated();
+    }
+    if (!frame_queue_.IsEmpty() && !frame_pacer_.IsRunning() &&
+        is_clock_running) {
+      // Come back for the frames that are not due yet. Pop() has taken every
+      // frame due at |clock_ms|, so while the clock stands still the rest
+      // never become due and are picked up after the next push or resume.
+      texture_registrar_->MarkTextureFrameAvailable(texture_id_);
+    }
   }
-  if (!prepared_media_packet_ && !current_media_packet_) {
+  if (!current_media_packet_) {
     LOG_ERROR("No vaild media packet");
     return nullptr;
   }
-  if (prepared_media_packet_ && !current_media_packet_) {
-    current_media_packet_ = prepared_media_packet_;
-    prepared_media_packet_ = nullptr;
-  }
+  is_current_media_packet_in_use_ = true;
   tbm_surface_h surface;
   media_packet_get_tbm_surface(current_media_packet_, &surface);
   flutter_desktop_gpu_buffer_->buffer = surface;
@@ -87,16 +110,22 @@ FlutterDesktopGpuBuffer *VideoPlayer::ObtainGpuBuffer(size_t width,
 }
 
 void VideoPlayer::Destruct(void *buffer) {
+  // The current packet is kept, so that it can be presented again if no new
+  // frame is due on the next call to ObtainGpuBuffer, unless the player has
+  // been reset while it was on screen.
   std::lock_guard<std::mutex> lock(mutex_);
-  if (current_media_packet_) {
+  is_current_media_packet_in_use_ = false;
+  if (is_current_media_packet_stale_) {
     media_packet_destroy(current_media_packet_);
     current_media_packet_ = nullptr;
+    is_current_media_packet_stale_ = false;
   }
 }
 
 VideoPlayer::VideoPlayer(flutter::PluginRegistrar *plugin_registrar,
                          flutter::TextureRegistrar *texture_registrar,
-                         const std::string &uri, VideoPlayerOptions &options) {
+                         const std::string &uri, VideoPlayerOptions &options)
+    : frame_queue_(FRAME_QUEUE_CAPACITY) {
   is_initialized_ = false;
   texture_registrar_ = texture_registrar;
 
@@ -119,16 +148,6 @@ VideoPlayer::VideoPlayer(flutter::PluginRegistrar *plugin_registrar,
     throw VideoPlayerError("player_create failed", get_error_message(ret));
   }
 
-  LOG_DEBUG("[VideoPlayer] call player_set_uri to set video path (%s)",
-            uri.c_str());
-  ret = player_set_uri(player_, uri.c_str());
-  if (ret != PLAYER_ERROR_NONE) {
-    player_destroy(player_);
-    LOG_ERROR("[VideoPlayer] player_set_uri failed: %s",
-              get_error_message(ret));
-    throw VideoPlayerError("player_set_uri failed", get_error_message(ret));
-  }
-
   LOG_DEBUG("[VideoPlayer] call player_set_display_visible");
   ret = player_set_display_visible(player_, true);
   if (ret != PLAYER_ERROR_NONE) {
@@ -194,17 +213,82 @@ VideoPlayer::VideoPlayer(flutter::PluginRegistrar *plugin_registrar,
                            get_error_message(ret));
   }
 
-  LOG_DEBUG("[VideoPlayer] call player_prepare_async");
+  // Buffering events are passed from the player thread to the main loop.
+  buffering_pipe_ = ecore_pipe_add(onBufferingPipe, this);
+
+  messenger_ = plugin_registrar->messenger();
+  try {
+    open(uri, options);
+  } catch (const VideoPlayerError &) {
+    ecore_pipe_del(buffering_pipe_);
+    player_destroy(player_);
+    throw;
+  }
+}
+
+void VideoPlayer::open(const std::string &uri,
+                       const VideoPlayerOptions &options) {
+  setBufferingThrottle(options.getBufferingMinIntervalMs(),
+                       options.getBufferingMinPercentDelta());
+
+  LOG_DEBUG("[VideoPlayer.open] call player_set_uri to set video path (%s)",
+            uri.c_str());
+  int ret = player_set_uri(player_, uri.c_str());
+  if (ret != PLAYER_ERROR_NONE) {
+    LOG_ERROR("[VideoPlayer.open] player_set_uri failed: %s",
+              get_error_message(ret));
+    throw VideoPlayerError("player_set_uri failed", get_error_message(ret));
+  }
+
+  LOG_DEBUG("[VideoPlayer.open] call player_prepare_async");
   ret = player_prepare_async(player_, onPrepared, (void *)this);
   if (ret != PLAYER_ERROR_NONE) {
-    player_destroy(player_);
-    LOG_ERROR("[VideoPlayer] player_prepare_async failed: %s",
+    LOG_ERROR("[VideoPlayer.open] player_prepare_async failed: %s",
               get_error_message(ret));
     throw VideoPlayerError("player_prepare_async failed",
                            get_error_message(ret));
   }
 
-  setupEventChannel(plugin_registrar->messenger());
+  setupEventChannel(messenger_);
+}
+
+bool VideoPlayer::reset() {
+  LOG_DEBUG("[VideoPlayer.reset] reset video player for reuse");
+  is_initialized_ = false;
+  event_sink_ = nullptr;
+  event_channel_->SetStreamHandler(nullptr);
+  on_seek_completed_ = nullptr;
+
+  int ret = player_unprepare(player_);
+  if (ret != PLAYER_ERROR_NONE) {
+    LOG_ERROR("[VideoPlayer.reset] player_unprepare failed: %s",
+              get_error_message(ret));
+    return false;
+  }
+  player_set_looping(player_, false);
+  player_set_volume(player_, 1.0, 1.0);
+  // No more buffering callbacks after player_unprepare.
+  last_buffering_percent_ = -1;
+  is_buffering_ = false;
+
+  last_stats_time_ = std::chrono::steady_clock::time_point();
+  last_stats_rendered_frames_ = 0;
+  frame_pacer_.Stop();
+  frame_pacer_.ResetStats();
+  playback_speed_ = 1.0;
+  playback_clock_.Reset();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  frame_queue_.Flush();
+  frame_queue_.ResetStats();
+  if (is_current_media_packet_in_use_) {
+    // The raster thread may still read from it. Destruct() destroys it.
+    is_current_media_packet_stale_ = true;
+  } else if (current_media_packet_) {
+    media_packet_destroy(current_media_packet_);
+    current_media_packet_ = nullptr;
+  }
+  return true;
 }
 
 VideoPlayer::~VideoPlayer() {
@@ -232,6 +316,28 @@ void VideoPlayer::play() {
               get_error_message(ret));
     throw VideoPlayerError("player_start failed", get_error_message(ret));
   }
+  syncPlaybackClock();
+  playback_clock_.SetRunning(true);
+  startFramePacing();
+}
+
+void VideoPlayer::startFramePacing() {
+  // While playing, new frames are requested on display refresh ticks rather
+  // than whenever the decoder outputs one.
+  frame_pacer_.Start([this]() {
+    if (playback_clock_.GetMsSinceSync() >= CLOCK_SYNC_INTERVAL_MS) {
+      syncPlaybackClock();
+    }
+    texture_registrar_->MarkTextureFrameAvailable(texture_id_);
+  });
+}
+
+void VideoPlayer::syncPlaybackClock() {
+  int position;
+  if (player_ &&
+      player_get_play_position(player_, &position) == PLAYER_ERROR_NONE) {
+    playback_clock_.Sync(position);
+  }
 }
 
 void VideoPlayer::pause() {
@@ -246,12 +352,15 @@ void VideoPlayer::pause() {
     }
   }
 
+  frame_pacer_.Stop();
   ret = player_pause(player_);
   if (ret != PLAYER_ERROR_NONE) {
     LOG_ERROR("[VideoPlayer.pause] player_pause failed: %s",
               get_error_message(ret));
     throw VideoPlayerError("player_pause failed", get_error_message(ret));
   }
+  playback_clock_.SetRunning(false);
+  syncPlaybackClock();
 }
 
 void VideoPlayer::setLooping(bool is_looping) {
@@ -284,11 +393,17 @@ void VideoPlayer::setPlaybackSpeed(double speed) {
     throw VideoPlayerError("player_set_playback_rate failed",
                            get_error_message(ret));
   }
+  playback_speed_ = speed;
+  playback_clock_.SetSpeed(speed);
 }
 
 void VideoPlayer::seekTo(int position,
                          const SeekCompletedCb &seek_completed_cb) {
   LOG_DEBUG("[VideoPlayer.seekTo] position: %d", position);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frame_queue_.Flush();
+  }
   int ret =
       player_set_play_position(player_, position, true, onSeekCompleted, this);
   if (ret != PLAYER_ERROR_NONE) {
@@ -297,6 +412,7 @@ void VideoPlayer::seekTo(int position,
     throw VideoPlayerError("player_set_play_position failed",
                            get_error_message(ret));
   } else {
+    playback_clock_.Sync(position);
     on_seek_completed_ = seek_completed_cb;
   }
 }
@@ -316,31 +432,126 @@ int VideoPlayer::getPosition() {
   return position;
 }
 
+void VideoPlayer::sendPlaybackStats() {
+  if (!is_initialized_ || !event_sink_) {
+    return;
+  }
+  player_state_e state;
+  int ret = player_get_state(player_, &state);
+  if (ret != PLAYER_ERROR_NONE || state != PLAYER_STATE_PLAYING) {
+    // Don't count the paused time into the next frame rate.
+    last_stats_time_ = std::chrono::steady_clock::time_point();
+    return;
+  }
+  int position;
+  ret = player_get_play_position(player_, &position);
+  if (ret != PLAYER_ERROR_NONE) {
+    LOG_ERROR(
+        "[VideoPlayer.sendPlaybackStats] player_get_play_position failed: %s",
+        get_error_message(ret));
+    return;
+  }
+  playback_clock_.Sync(position);
+
+  VideoFrameStats stats;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats = frame_queue_.GetStats();
+  }
+  auto now = std::chrono::steady_clock::now();
+  double fps = 0;
+  if (last_stats_time_ != std::chrono::steady_clock::time_point()) {
+    std::chrono::duration<double> elapsed = now - last_stats_time_;
+    if (elapsed.count() > 0) {
+      fps = (stats.rendered - last_stats_rendered_frames_) / elapsed.count();
+    }
+  }
+  last_stats_time_ = now;
+  last_stats_rendered_frames_ = stats.rendered;
+
+  flutter::EncodableMap encodables = {
+      {flutter::EncodableValue("event"),
+       flutter::EncodableValue("playbackStats")},
+      {flutter::EncodableValue("position"), flutter::EncodableValue(position)},
+      {flutter::EncodableValue("decodedFrames"),
+       flutter::EncodableValue((int64_t)stats.decoded)},
+      {flutter::EncodableValue("droppedFrames"),
+       flutter::EncodableValue((int64_t)stats.dropped)},
+      {flutter::EncodableValue("renderedFps"), flutter::EncodableValue(fps)},
+      {flutter::EncodableValue("framesShownLonger"),
+       flutter::EncodableValue((int64_t)frame_pacer_.GetFramesShownLonger())},
+      {flutter::EncodableValue("framesShownShorter"),
+       flutter::EncodableValue(
+           (int64_t)frame_pacer_.GetFramesShownShorter())}};
+
+  flutter::EncodableList rangeList;
+  if (getBufferedRanges(rangeList)) {
+    encodables[flutter::EncodableValue("buffered")] =
+        flutter::EncodableValue(rangeList);
+  }
+  event_sink_->Success(flutter::EncodableValue(encodables));
+}
+
+bool VideoPlayer::getBufferedRanges(flutter::EncodableList &ranges) {
+  // Only available for streaming sources.
+  int start_percent, end_percent, duration;
+  if (player_get_streaming_download_progress(player_, &start_percent,
+                                             &end_percent) !=
+          PLAYER_ERROR_NONE ||
+      player_get_duration(player_, &duration) != PLAYER_ERROR_NONE) {
+    return false;
+  }
+  flutter::EncodableList range = {
+      flutter::EncodableValue((int64_t)duration * start_percent / 100),
+      flutter::EncodableValue((int64_t)duration * end_percent / 100)};
+  ranges = {flutter::EncodableValue(range)};
+  return true;
+}
+
+void VideoPlayer::setBufferingThrottle(int min_interval_ms,
+                                       int min_percent_delta) {
+  buffering_min_interval_ms_ = min_interval_ms;
+  buffering_min_percent_delta_ = min_percent_delta;
+}
+
 void VideoPlayer::dispose() {
   LOG_DEBUG("[VideoPlayer.dispose] dispose video player");
   is_initialized_ = false;
   event_sink_ = nullptr;
   event_channel_->SetStreamHandler(nullptr);
+  frame_pacer_.Stop();
 
   if (player_) {
-    player_unprepare(player_);
-    player_unset_media_packet_video_frame_decoded_cb(player_);
-    player_unset_buffering_cb(player_);
-    player_unset_completed_cb(player_);
-    player_unset_interrupted_cb(player_);
-    player_unset_error_cb(player_);
-    player_destroy(player_);
+    player_h player = player_;
     player_ = 0;
-  }
-
-  if (current_media_packet_) {
-    media_packet_destroy(current_media_packet_);
-    current_media_packet_ = nullptr;
-  }
-
-  if (prepared_media_packet_) {
-    media_packet_destroy(prepared_media_packet_);
-    prepared_media_packet_ = nullptr;
+    player_unprepare(player);
+    player_unset_media_packet_video_frame_decoded_cb(player);
+    player_unset_buffering_cb(player);
+    player_unset_completed_cb(player);
+    player_unset_interrupted_cb(player);
+    player_unset_error_cb(player);
+    player_destroy(player);
+  }
+
+  if (buffering_pipe_) {
+    ecore_pipe_del(buffering_pipe_);
+    buffering_pipe_ = nullptr;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const VideoFrameStats &stats = frame_queue_.GetStats();
+    LOG_INFO(
+        "[VideoPlayer.dispose] frames rendered: %llu, dropped: %llu, "
+        "duplicated: %llu",
+        (unsigned long long)stats.rendered, (unsigned long long)stats.dropped,
+        (unsigned long long)stats.duplicated);
+    frame_queue_.Flush();
+    if (current_media_packet_) {
+      media_packet_destroy(current_media_packet_);
+      current_media_packet_ = nullptr;
+    }
+    is_current_media_packet_stale_ = false;
   }
 
   if (texture_registrar_) {
@@ -465,11 +676,12 @@ void VideoPlayer::sendBufferingStart() {
   }
 }
 
-void VideoPlayer::sendBufferingUpdate(int position) {
+void VideoPlayer::sendBufferingUpdate() {
   if (event_sink_) {
-    flutter::EncodableList range = {flutter::EncodableValue(0),
-                                    flutter::EncodableValue(position)};
-    flutter::EncodableList rangeList = {flutter::EncodableValue(range)};
+    flutter::EncodableList rangeList;
+    if (!getBufferedRanges(rangeList)) {
+      return;
+    }
     flutter::EncodableMap encodables = {
         {flutter::EncodableValue("event"),
          flutter::EncodableValue("bufferingUpdate")},
@@ -504,6 +716,43 @@ void VideoPlayer::onPrepared(void *data) {
 void VideoPlayer::onBuffering(int percent, void *data) {
   // percent isn't used for video size, it's the used storage of buffer
   LOG_DEBUG("[VideoPlayer.onBuffering] percent: %d", percent);
+  VideoPlayer *player = (VideoPlayer *)data;
+
+  // Called for every percent change, so forward only the start, the end and
+  // changes that are both large and late enough.
+  auto now = std::chrono::steady_clock::now();
+  int last_percent = player->last_buffering_percent_;
+  bool is_boundary = last_percent < 0 || last_percent >= 100 || percent >= 100;
+  if (!is_boundary) {
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - player->last_buffering_time_);
+    if (std::abs(percent - last_percent) <
+            player->buffering_min_percent_delta_ ||
+        elapsed.count() < player->buffering_min_interval_ms_) {
+      return;
+    }
+  }
+  player->last_buffering_percent_ = percent;
+  player->last_buffering_time_ = now;
+  ecore_pipe_write(player->buffering_pipe_, &percent, sizeof(percent));
+}
+
+void VideoPlayer::onBufferingPipe(void *data, void *buffer,
+                                  unsigned int nbyte) {
+  VideoPlayer *player = (VideoPlayer *)data;
+  if (nbyte != sizeof(int)) {
+    return;
+  }
+  int percent = *static_cast<int *>(buffer);
+  if (percent < 100 && !player->is_buffering_) {
+    player->is_buffering_ = true;
+    player->sendBufferingStart();
+  }
+  player->sendBufferingUpdate();
+  if (percent >= 100 && player->is_buffering_) {
+    player->is_buffering_ = false;
+    player->sendBufferingEnd();
+  }
 }
 
 void VideoPlayer::onSeekCompleted(void *data) {
@@ -557,12 +806,13 @@ void VideoPlayer::onErrorOccurred(int code, void *data) {
 void VideoPlayer::onVideoFrameDecoded(media_packet_h packet, void *data) {
   VideoPlayer *player = (VideoPlayer *)data;
   std::lock_guard<std::mutex> lock(player->mutex_);
-  if (player->prepared_media_packet_) {
-    LOG_INFO("prepared packet not null, store new");
-    media_packet_destroy(player->prepared_media_packet_);
-    player->prepared_media_packet_ = packet;
-    return;
+  if (player->frame_queue_.Push(packet)) {
+    // Looped. Follow the new timestamps until the next sync.
+    player->playback_clock_.Sync(player->frame_queue_.GetLastPtsMs());
+  }
+  player->frame_pacer_.SetFrameInterval(
+      player->frame_queue_.GetFrameIntervalMs() / player->playback_speed_);
+  if (!player->frame_pacer_.IsRunning()) {
+    player->texture_registrar_->MarkTextureFrameAvailable(player->texture_id_);
   }
-  player->prepared_media_packet_ = packet;
-  player->texture_registrar_->MarkTextureFrameAvailable(player->texture_id_);
 }
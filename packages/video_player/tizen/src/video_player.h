@@ -1,16 +1,22 @@
 #ifndef VIDEO_PLAYER_H_
 #define VIDEO_PLAYER_H_
 
+#include <Ecore.h>
 #include <flutter/encodable_value.h>
 #include <flutter/event_channel.h>
 #include <flutter/plugin_registrar.h>
 #include <player.h>
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 
+#include "frame_pacer.h"
+#include "playback_clock.h"
+#include "video_frame_queue.h"
 #include "video_player_options.h"
 
 using SeekCompletedCb = std::function<void()>;
@@ -23,6 +29,12 @@ class VideoPlayer {
   ~VideoPlayer();
 
   long getTextureId();
+  // Applies |options| and prepares |uri|. Also called on a player that has
+  // been reset, which must not keep the options of its previous use.
+  void open(const std::string &uri, const VideoPlayerOptions &options);
+  // Unprepares the player and detaches it from the event channel, so that it
+  // can be reused with open(). Returns false if the player cannot be reused.
+  bool reset();
   void play();
   void pause();
   void setLooping(bool is_looping);
@@ -32,20 +44,32 @@ class VideoPlayer {
               const SeekCompletedCb &seek_completed_cb);  // milliseconds
   int getPosition();                                      // milliseconds
   void dispose();
+  // Sends the position, the buffered range and frame statistics as a
+  // playbackStats event if the player is playing.
+  void sendPlaybackStats();
+  // Buffering events are sent only if the buffering percent has changed by
+  // at least |min_percent_delta| and |min_interval_ms| has passed since the
+  // last event, except for the first and the last one.
+  void setBufferingThrottle(int min_interval_ms, int min_percent_delta);
 
  private:
   void initialize();
   void setupEventChannel(flutter::BinaryMessenger *messenger);
   void sendInitialized();
   void sendBufferingStart();
-  void sendBufferingUpdate(int position);  // milliseconds
+  void sendBufferingUpdate();
   void sendBufferingEnd();
   FlutterDesktopGpuBuffer *ObtainGpuBuffer(size_t width, size_t height);
   void Destruct(void *buffer);
   bool IsValidMediaPacket(media_packet_h media_packet);
+  void startFramePacing();
+  // Reads the position from the player. Must be called on the main thread.
+  void syncPlaybackClock();
+  bool getBufferedRanges(flutter::EncodableList &ranges);
 
   static void onPrepared(void *data);
   static void onBuffering(int percent, void *data);
+  static void onBufferingPipe(void *data, void *buffer, unsigned int nbyte);
   static void onSeekCompleted(void *data);
   static void onPlayCompleted(void *data);
   static void onInterrupted(player_interrupted_code_e code, void *data);
@@ -54,6 +78,7 @@ class VideoPlayer {
 
   bool is_initialized_;
   player_h player_;
+  flutter::BinaryMessenger *messenger_;
   std::unique_ptr<flutter::EventChannel<flutter::EncodableValue>>
       event_channel_;
   std::unique_ptr<flutter::EventSink<flutter::EncodableValue>> event_sink_;
@@ -63,8 +88,25 @@ class VideoPlayer {
   std::unique_ptr<FlutterDesktopGpuBuffer> flutter_desktop_gpu_buffer_;
   std::mutex mutex_;
   SeekCompletedCb on_seek_completed_;
-  media_packet_h prepared_media_packet_ = nullptr;
+  VideoFrameQueue frame_queue_;
   media_packet_h current_media_packet_ = nullptr;
+  bool is_current_media_packet_in_use_ = false;
+  // Set if the player was reset while the current packet was on screen.
+  bool is_current_media_packet_stale_ = false;
+  FramePacer frame_pacer_;
+  PlaybackClock playback_clock_;
+  // Written by the main thread and read by the player thread.
+  std::atomic<double> playback_speed_{1.0};
+  Ecore_Pipe *buffering_pipe_ = nullptr;
+  std::atomic<int> buffering_min_interval_ms_{0};
+  std::atomic<int> buffering_min_percent_delta_{0};
+  // Only accessed by the player thread.
+  int last_buffering_percent_ = -1;
+  std::chrono::steady_clock::time_point last_buffering_time_;
+  // Only accessed by the main thread.
+  bool is_buffering_ = false;
+  std::chrono::steady_clock::time_point last_stats_time_;
+  uint64_t last_stats_rendered_frames_ = 0;
 };
 
 #endif  // VIDEO_PLAYER_H_
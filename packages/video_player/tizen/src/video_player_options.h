@@ -3,7 +3,10 @@
 
 class VideoPlayerOptions {
  public:
-  VideoPlayerOptions() : mixWithOthers_(true) {}
+  VideoPlayerOptions()
+      : mixWithOthers_(true),
+        bufferingMinIntervalMs_(250),
+        bufferingMinPercentDelta_(5) {}
   ~VideoPlayerOptions() = default;
 
   VideoPlayerOptions(const VideoPlayerOptions &other) = default;
@@ -12,8 +15,19 @@ class VideoPlayerOptions {
   void setMixWithOthers(bool mixWithOthers) { mixWithOthers_ = mixWithOthers; }
   bool getMixWithOthers() const { return mixWithOthers_; }
 
+  void setBufferingMinIntervalMs(int intervalMs) {
+    bufferingMinIntervalMs_ = intervalMs;
+  }
+  int getBufferingMinIntervalMs() const { return bufferingMinIntervalMs_; }
+  void setBufferingMinPercentDelta(int percentDelta) {
+    bufferingMinPercentDelta_ = percentDelta;
+  }
+  int getBufferingMinPercentDelta() const { return bufferingMinPercentDelta_; }
+
  private:
   bool mixWithOthers_;
+  int bufferingMinIntervalMs_;
+  int bufferingMinPercentDelta_;
 };
 
 #endif  // VIDEO_PLAYER_OPTIONS_H_
@@ -1,14 +1,19 @@
 #include "video_player_tizen_plugin.h"
 
+#include <Ecore.h>
 #include <app_common.h>
 #include <flutter/event_channel.h>
 #include <flutter/event_stream_handler_functions.h>
 #include <flutter/plugin_registrar.h>
 #include <flutter/standard_method_codec.h>
+#include <runtime_info.h>
 
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "flutter_texture_registrar.h"
 #include "log.h"
@@ -17,6 +22,12 @@
 #include "video_player_error.h"
 #include "video_player_options.h"
 
+// The number of reset players kept for reuse by create().
+#define MAX_IDLE_PLAYERS 2
+// Idle players are released while the available system memory (free and
+// cache) is below this size.
+#define MIN_AVAILABLE_MEMORY_KB (64 * 1024)
+
 class VideoPlayerTizenPlugin : public flutter::Plugin, public VideoPlayerApi {
  public:
   static void RegisterWithRegistrar(
@@ -40,14 +51,36 @@ class VideoPlayerTizenPlugin : public flutter::Plugin, public VideoPlayerApi {
                       const SeekCompletedCb &onSeekCompleted) override;
   virtual void setMixWithOthers(
       const MixWithOthersMessage &mixWithOthersMsg) override;
+  virtual void preload(const CreateMessage &createMsg) override;
+  virtual void setMaxPreloadedPlayers(
+      const PreloadLimitMessage &preloadLimitMsg) override;
+  virtual void setPlaybackStatsInterval(
+      const PlaybackStatsIntervalMessage &intervalMsg) override;
+  virtual void setBufferingThrottle(
+      const BufferingThrottleMessage &throttleMsg) override;
 
  private:
   void disposeAllPlayers();
+  void trimPreloadedPlayers(size_t maxCount);
+  std::string resolveUri(const CreateMessage &createMsg);
+  std::unique_ptr<VideoPlayer> createPlayer(const std::string &uri);
+  void releasePlayer(std::unique_ptr<VideoPlayer> player);
+  void trimIdlePlayers();
+  static Eina_Bool onPlaybackStatsTimer(void *data);
 
   flutter::PluginRegistrar *pluginRegistrar_;
   flutter::TextureRegistrar *textureRegistrar_;
   VideoPlayerOptions options_;
   std::map<long, std::unique_ptr<VideoPlayer>> videoPlayers_;
+  // Players that are prepared but not yet returned by create(), keyed by uri,
+  // oldest first.
+  std::list<std::pair<std::string, std::unique_ptr<VideoPlayer>>>
+      preloadedPlayers_;
+  size_t maxPreloadedPlayers_ = 1;
+  // Reset players whose textures stay registered, newest last.
+  std::vector<std::unique_ptr<VideoPlayer>> idlePlayers_;
+  // Sends playbackStats events of all players while enabled.
+  Ecore_Timer *playbackStatsTimer_ = nullptr;
 };
 
 // static
@@ -66,17 +99,88 @@ VideoPlayerTizenPlugin::VideoPlayerTizenPlugin(
   VideoPlayerApi::setup(pluginRegistrar->messenger(), this);
 }
 
-VideoPlayerTizenPlugin::~VideoPlayerTizenPlugin() { disposeAllPlayers(); }
+VideoPlayerTizenPlugin::~VideoPlayerTizenPlugin() {
+  if (playbackStatsTimer_) {
+    ecore_timer_del(playbackStatsTimer_);
+    playbackStatsTimer_ = nullptr;
+  }
+  disposeAllPlayers();
+  for (auto &player : idlePlayers_) {
+    player->dispose();
+  }
+  idlePlayers_.clear();
+}
 
 void VideoPlayerTizenPlugin::disposeAllPlayers() {
   LOG_DEBUG("[VideoPlayerTizenPlugin.disposeAllPlayers] player count: %d",
             videoPlayers_.size());
   auto iter = videoPlayers_.begin();
   while (iter != videoPlayers_.end()) {
-    iter->second->dispose();
+    releasePlayer(std::move(iter->second));
     iter++;
   }
   videoPlayers_.clear();
+  trimPreloadedPlayers(0);
+}
+
+std::unique_ptr<VideoPlayer> VideoPlayerTizenPlugin::createPlayer(
+    const std::string &uri) {
+  trimIdlePlayers();
+  while (!idlePlayers_.empty()) {
+    std::unique_ptr<VideoPlayer> player = std::move(idlePlayers_.back());
+    idlePlayers_.pop_back();
+    try {
+      player->open(uri, options_);
+      LOG_DEBUG("[VideoPlayerTizenPlugin.createPlayer] reuse textureId: %ld",
+                player->getTextureId());
+      return player;
+    } catch (const VideoPlayerError &e) {
+      LOG_ERROR("[VideoPlayerTizenPlugin.createPlayer] open failed: %s",
+                e.getMessage().c_str());
+      player->dispose();
+    }
+  }
+  return std::make_unique<VideoPlayer>(pluginRegistrar_, textureRegistrar_, uri,
+                                       options_);
+}
+
+void VideoPlayerTizenPlugin::releasePlayer(
+    std::unique_ptr<VideoPlayer> player) {
+  if (idlePlayers_.size() < MAX_IDLE_PLAYERS && player->reset()) {
+    idlePlayers_.push_back(std::move(player));
+    trimIdlePlayers();
+  } else {
+    player->dispose();
+  }
+}
+
+void VideoPlayerTizenPlugin::trimIdlePlayers() {
+  if (idlePlayers_.empty()) {
+    return;
+  }
+  runtime_memory_info_s info;
+  int ret = runtime_info_get_system_memory_info(&info);
+  if (ret != RUNTIME_INFO_ERROR_NONE ||
+      info.free + info.cache >= MIN_AVAILABLE_MEMORY_KB) {
+    return;
+  }
+  LOG_INFO(
+      "[VideoPlayerTizenPlugin.trimIdlePlayers] low memory (%d KB), "
+      "release %zu idle players",
+      info.free + info.cache, idlePlayers_.size());
+  for (auto &player : idlePlayers_) {
+    player->dispose();
+  }
+  idlePlayers_.clear();
+}
+
+void VideoPlayerTizenPlugin::trimPreloadedPlayers(size_t maxCount) {
+  while (preloadedPlayers_.size() > maxCount) {
+    LOG_DEBUG("[VideoPlayerTizenPlugin.trimPreloadedPlayers] evict uri: %s",
+              preloadedPlayers_.front().first.c_str());
+    releasePlayer(std::move(preloadedPlayers_.front().second));
+    preloadedPlayers_.pop_front();
+  }
 }
 
 void VideoPlayerTizenPlugin::initialize() {
@@ -94,6 +198,35 @@ TextureMessage VideoPlayerTizenPlugin::create(const CreateMessage &createMsg) {
   LOG_DEBUG("[VideoPlayerTizenPlugin.create] formatHint: %s",
             createMsg.getFormatHint().c_str());
 
+  std::string uri = resolveUri(createMsg);
+  LOG_DEBUG("[VideoPlayerTizenPlugin.create] uri of video player: %s",
+            uri.c_str());
+
+  for (auto iter = preloadedPlayers_.begin(); iter != preloadedPlayers_.end();
+       iter++) {
+    if (iter->first == uri) {
+      LOG_DEBUG("[VideoPlayerTizenPlugin.create] use preloaded player");
+      long textureId = iter->second->getTextureId();
+      videoPlayers_[textureId] = std::move(iter->second);
+      preloadedPlayers_.erase(iter);
+
+      TextureMessage result;
+      result.setTextureId(textureId);
+      return result;
+    }
+  }
+
+  std::unique_ptr<VideoPlayer> player = createPlayer(uri);
+  long textureId = player->getTextureId();
+  videoPlayers_[textureId] = std::move(player);
+
+  TextureMessage result;
+  result.setTextureId(textureId);
+  return result;
+}
+
+std::string VideoPlayerTizenPlugin::resolveUri(
+    const CreateMessage &createMsg) {
   std::string uri;
   if (createMsg.getAsset().empty()) {
     uri = createMsg.getUri();
@@ -104,22 +237,12 @@ TextureMessage VideoPlayerTizenPlugin::create(const CreateMessage &createMsg) {
       free(resPath);
     } else {
       LOG_DEBUG(
-          "[VideoPlayerTizenPlugin.create] failed to get resource path "
+          "[VideoPlayerTizenPlugin.resolveUri] failed to get resource path "
           "of package");
       throw VideoPlayerError("Internal error", "Failed to get resource path.");
     }
   }
-  LOG_DEBUG("[VideoPlayerTizenPlugin.create] uri of video player: %s",
-            uri.c_str());
-
-  auto player = std::make_unique<VideoPlayer>(pluginRegistrar_,
-                                              textureRegistrar_, uri, options_);
-  long textureId = player->getTextureId();
-  videoPlayers_[textureId] = std::move(player);
-
-  TextureMessage result;
-  result.setTextureId(textureId);
-  return result;
+  return uri;
 }
 
 void VideoPlayerTizenPlugin::dispose(const TextureMessage &textureMsg) {
@@ -128,7 +251,7 @@ void VideoPlayerTizenPlugin::dispose(const TextureMessage &textureMsg) {
 
   auto iter = videoPlayers_.find(textureMsg.getTextureId());
   if (iter != videoPlayers_.end()) {
-    iter->second->dispose();
+    releasePlayer(std::move(iter->second));
     videoPlayers_.erase(iter);
   }
 }
@@ -224,6 +347,81 @@ void VideoPlayerTizenPlugin::setMixWithOthers(
   options_.setMixWithOthers(mixWithOthersMsg.getMixWithOthers());
 }
 
+void VideoPlayerTizenPlugin::preload(const CreateMessage &createMsg) {
+  std::string uri = resolveUri(createMsg);
+  LOG_DEBUG("[VideoPlayerTizenPlugin.preload] uri: %s", uri.c_str());
+  if (maxPreloadedPlayers_ == 0) {
+    return;
+  }
+  for (const auto &preloaded : preloadedPlayers_) {
+    if (preloaded.first == uri) {
+      return;
+    }
+  }
+
+  // The player is prepared in the background and keeps its first decoded
+  // frame, so create() can return it without any delay.
+  std::unique_ptr<VideoPlayer> player = createPlayer(uri);
+  trimPreloadedPlayers(maxPreloadedPlayers_ - 1);
+  preloadedPlayers_.emplace_back(uri, std::move(player));
+}
+
+void VideoPlayerTizenPlugin::setMaxPreloadedPlayers(
+    const PreloadLimitMessage &preloadLimitMsg) {
+  LOG_DEBUG(
+      "[VideoPlayerTizenPlugin.setMaxPreloadedPlayers] "
+      "maxPreloadedPlayers: %ld",
+      preloadLimitMsg.getMaxPreloadedPlayers());
+  long maxCount = preloadLimitMsg.getMaxPreloadedPlayers();
+  maxPreloadedPlayers_ = maxCount > 0 ? maxCount : 0;
+  trimPreloadedPlayers(maxPreloadedPlayers_);
+}
+
+void VideoPlayerTizenPlugin::setPlaybackStatsInterval(
+    const PlaybackStatsIntervalMessage &intervalMsg) {
+  LOG_DEBUG("[VideoPlayerTizenPlugin.setPlaybackStatsInterval] intervalMs: %ld",
+            intervalMsg.getIntervalMs());
+  if (playbackStatsTimer_) {
+    ecore_timer_del(playbackStatsTimer_);
+    playbackStatsTimer_ = nullptr;
+  }
+  if (intervalMsg.getIntervalMs() > 0) {
+    playbackStatsTimer_ = ecore_timer_add(
+        intervalMsg.getIntervalMs() / 1000.0, onPlaybackStatsTimer, this);
+    if (!playbackStatsTimer_) {
+      throw VideoPlayerError("Internal error", "Failed to add a timer.");
+    }
+  }
+}
+
+void VideoPlayerTizenPlugin::setBufferingThrottle(
+    const BufferingThrottleMessage &throttleMsg) {
+  LOG_DEBUG(
+      "[VideoPlayerTizenPlugin.setBufferingThrottle] minIntervalMs: %ld, "
+      "minPercentDelta: %ld",
+      throttleMsg.getMinIntervalMs(), throttleMsg.getMinPercentDelta());
+  options_.setBufferingMinIntervalMs(throttleMsg.getMinIntervalMs());
+  options_.setBufferingMinPercentDelta(throttleMsg.getMinPercentDelta());
+  for (auto &iter : videoPlayers_) {
+    iter.second->setBufferingThrottle(options_.getBufferingMinIntervalMs(),
+                                      options_.getBufferingMinPercentDelta());
+  }
+  for (auto &preloaded : preloadedPlayers_) {
+    preloaded.second->setBufferingThrottle(
+        options_.getBufferingMinIntervalMs(),
+        options_.getBufferingMinPercentDelta());
+  }
+}
+
+// static
+Eina_Bool VideoPlayerTizenPlugin::onPlaybackStatsTimer(void *data) {
+  auto *plugin = static_cast<VideoPlayerTizenPlugin *>(data);
+  for (auto &iter : plugin->videoPlayers_) {
+    iter.second->sendPlaybackStats();
+  }
+  return ECORE_CALLBACK_RENEW;
+}
+
 void VideoPlayerTizenPluginRegisterWithRegistrar(
     FlutterDesktopPluginRegistrarRef registrar) {
   VideoPlayerTizenPlugin::RegisterWithRegistrar(
@@ -0,0 +1,15 @@
+// A minimal stand-in for the Tizen dlog API, used by the host tests. Logs are
+// discarded.
+
+#ifndef FAKE_DLOG_H_
+#define FAKE_DLOG_H_
+
+#include <string.h>
+
+enum { DLOG_DEBUG, DLOG_INFO, DLOG_WARN, DLOG_ERROR };
+
+inline int dlog_print(int priority, const char *tag, const char *format, ...) {
+  return 0;
+}
+
+#endif  // FAKE_DLOG_H_
@@ -0,0 +1,42 @@
+// A minimal stand-in for the Flutter basic message channel, used by the host
+// tests. The handler outlives the channel, as with the real messenger.
+
+#ifndef FAKE_FLUTTER_BASIC_MESSAGE_CHANNEL_H_
+#define FAKE_FLUTTER_BASIC_MESSAGE_CHANNEL_H_
+
+#include <flutter/binary_messenger.h>
+#include <flutter/encodable_value.h>
+#include <flutter/standard_message_codec.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace flutter {
+
+template <typename T>
+using MessageReply = std::function<void(const T &reply)>;
+
+template <typename T>
+using MessageHandler =
+    std::function<void(const T &message, const MessageReply<T> &reply)>;
+
+template <typename T>
+class BasicMessageChannel {
+ public:
+  BasicMessageChannel(BinaryMessenger *messenger, const std::string &name,
+                      const StandardMessageCodec *codec)
+      : messenger_(messenger), name_(name) {}
+
+  void SetMessageHandler(const MessageHandler<T> &handler) const {
+    messenger_->SetMessageHandler(name_, handler);
+  }
+
+ private:
+  BinaryMessenger *messenger_;
+  std::string name_;
+};
+
+}  // namespace flutter
+
+#endif  // FAKE_FLUTTER_BASIC_MESSAGE_CHANNEL_H_
@@ -0,0 +1,45 @@
+// A minimal stand-in for the Flutter binary messenger, used by the host
+// tests. Instead of encoding messages, it passes them to the handler that was
+// set for the channel as they are.
+
+#ifndef FAKE_FLUTTER_BINARY_MESSENGER_H_
+#define FAKE_FLUTTER_BINARY_MESSENGER_H_
+
+#include <flutter/encodable_value.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+
+namespace flutter {
+
+class BinaryMessenger {
+ public:
+  using Handler =
+      std::function<void(const EncodableValue &,
+                         const std::function<void(const EncodableValue &)> &)>;
+
+  void SetMessageHandler(const std::string &channel, Handler handler) {
+    handlers_[channel] = std::move(handler);
+  }
+
+  // Delivers |message| to the handler of |channel|. Returns false if there is
+  // no handler. |reply| is called when the handler replies.
+  bool Send(const std::string &channel, const EncodableValue &message,
+            const std::function<void(const EncodableValue &)> &reply) const {
+    auto iter = handlers_.find(channel);
+    if (iter == handlers_.end()) {
+      return false;
+    }
+    iter->second(message, reply);
+    return true;
+  }
+
+ private:
+  std::map<std::string, Handler> handlers_;
+};
+
+}  // namespace flutter
+
+#endif  // FAKE_FLUTTER_BINARY_MESSENGER_H_
@@ -0,0 +1,38 @@
+// A minimal stand-in for the Flutter encodable value, used by the host tests.
+
+#ifndef FAKE_FLUTTER_ENCODABLE_VALUE_H_
+#define FAKE_FLUTTER_ENCODABLE_VALUE_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace flutter {
+
+class EncodableValue;
+
+using EncodableList = std::vector<EncodableValue>;
+using EncodableMap = std::map<EncodableValue, EncodableValue>;
+
+class EncodableValue
+    : public std::variant<std::monostate, bool, int32_t, int64_t, double,
+                          std::string, EncodableList, EncodableMap> {
+ public:
+  using variant::variant;
+  EncodableValue() = default;
+  explicit EncodableValue(const char *string) : variant(std::string(string)) {}
+
+  bool IsNull() const { return std::holds_alternative<std::monostate>(*this); }
+  int64_t LongValue() const {
+    if (std::holds_alternative<int32_t>(*this)) {
+      return std::get<int32_t>(*this);
+    }
+    return std::get<int64_t>(*this);
+  }
+};
+
+}  // namespace flutter
+
+#endif  // FAKE_FLUTTER_ENCODABLE_VALUE_H_
@@ -0,0 +1,19 @@
+// A minimal stand-in for the Flutter standard message codec, used by the host
+// tests. The fake messenger does not encode messages, so it does nothing.
+
+#ifndef FAKE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
+#define FAKE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
+
+namespace flutter {
+
+class StandardMessageCodec {
+ public:
+  static const StandardMessageCodec &GetInstance() {
+    static StandardMessageCodec instance;
+    return instance;
+  }
+};
+
+}  // namespace flutter
+
+#endif  // FAKE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+#include "message.h"
+
+namespace {
+
+void Measure(const char *name, int iterations,
+             const std::function<void()> &function) {
+  function();
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; i++) {
+    function();
+  }
+  std::chrono::duration<double, std::nano> elapsed =
+      std::chrono::steady_clock::now() - start;
+  printf("%-36s %10.1f ns\n", name, elapsed.count() / iterations);
+}
+
+// Decodes |request| and encodes a reply in the same layout, as a handler
+// does for every call.
+template <typename T>
+void MeasureLayouts(const char *name, int iterations, T message) {
+  flutter::EncodableValue map = message.toMap();
+  flutter::EncodableValue list = message.toList();
+  char label[64];
+  snprintf(label, sizeof(label), "%s, map", name);
+  Measure(label, iterations, [&]() {
+    T decoded = T::fromMap(map);
+    flutter::EncodableValue encoded = decoded.toMap();
+  });
+  snprintf(label, sizeof(label), "%s, list", name);
+  Measure(label, iterations, [&]() {
+    T decoded = T::fromMap(list);
+    flutter::EncodableValue encoded = decoded.toList();
+  });
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  int iterations = argc > 1 ? atoi(argv[1]) : 200000;
+
+  printf("decode + encode, %d iterations\n", iterations);
+  TextureMessage texture;
+  texture.setTextureId(1);
+  MeasureLayouts("TextureMessage", iterations, texture);
+
+  PositionMessage position;
+  position.setTextureId(1);
+  position.setPosition(123456);
+  MeasureLayouts("PositionMessage", iterations, position);
+
+  CreateMessage create;
+  create.setUri("https://example.com/videos/big_buck_bunny.mp4");
+  create.setFormatHint("other");
+  MeasureLayouts("CreateMessage", iterations, create);
+
+  BufferingThrottleMessage throttle;
+  throttle.setMinIntervalMs(250);
+  throttle.setMinPercentDelta(5);
+  MeasureLayouts("BufferingThrottleMessage", iterations, throttle);
+  return 0;
+}
@@ -0,0 +1,291 @@
+#include "message.h"
+
+#include <cstdio>
+#include <string>
+
+#include "test_util.h"
+
+namespace {
+
+const char *kChannelPrefix = "dev.flutter.pigeon.VideoPlayerApi.";
+
+flutter::EncodableValue Value(const char *string) {
+  return flutter::EncodableValue(string);
+}
+
+const flutter::EncodableValue *Find(const flutter::EncodableValue &value,
+                                    const char *key) {
+  auto *map = std::get_if<flutter::EncodableMap>(&value);
+  if (!map) {
+    return nullptr;
+  }
+  auto iter = map->find(Value(key));
+  return iter != map->end() ? &iter->second : nullptr;
+}
+
+// Encodes |message| in both layouts, decodes the results and passes them to
+// |check|.
+template <typename T, typename Check>
+void RoundTrip(T message, const Check &check) {
+  check(T::fromMap(message.toMap()), "map");
+  check(T::fromMap(message.toList()), "list");
+}
+
+void TestRoundTrip() {
+  TextureMessage texture;
+  texture.setTextureId(42);
+  RoundTrip(texture, [](const TextureMessage &decoded, const char *layout) {
+    EXPECT(decoded.getTextureId() == 42, "%s", layout);
+  });
+
+  CreateMessage create;
+  create.setAsset("assets/flutter.mp4");
+  create.setUri("https://example.com/video.m3u8");
+  create.setPackageName("video_player_example");
+  create.setFormatHint("hls");
+  RoundTrip(create, [](const CreateMessage &decoded, const char *layout) {
+    EXPECT(decoded.getAsset() == "assets/flutter.mp4", "%s", layout);
+    EXPECT(decoded.getUri() == "https://example.com/video.m3u8", "%s", layout);
+    EXPECT(decoded.getPackageName() == "video_player_example", "%s", layout);
+    EXPECT(decoded.getFormatHint() == "hls", "%s", layout);
+  });
+
+  LoopingMessage looping;
+  looping.setTextureId(3);
+  looping.setIsLooping(true);
+  RoundTrip(looping, [](const LoopingMessage &decoded, const char *layout) {
+    EXPECT(decoded.getTextureId() == 3, "%s", layout);
+    EXPECT(decoded.getIsLooping(), "%s", layout);
+  });
+
+  VolumeMessage volume;
+  volume.setTextureId(4);
+  volume.setVolume(0.25);
+  RoundTrip(volume, [](const VolumeMessage &decoded, const char *layout) {
+    EXPECT(decoded.getTextureId() == 4, "%s", layout);
+    EXPECT(decoded.getVolume() == 0.25, "%s", layout);
+  });
+
+  PlaybackSpeedMessage speed;
+  speed.setTextureId(5);
+  speed.setSpeed(1.5);
+  RoundTrip(speed, [](const PlaybackSpeedMessage &decoded, const char *layout) {
+    EXPECT(decoded.getTextureId() == 5, "%s", layout);
+    EXPECT(decoded.getSpeed() == 1.5, "%s", layout);
+  });
+
+  // Positions beyond 32 bits must survive both layouts.
+  PositionMessage position;
+  position.setTextureId(6);
+  position.setPosition(5000000000L);
+  RoundTrip(position, [](const PositionMessage &decoded, const char *layout) {
+    EXPECT(decoded.getTextureId() == 6, "%s", layout);
+    EXPECT(decoded.getPosition() == 5000000000L, "%s", layout);
+  });
+
+  MixWithOthersMessage mix;
+  mix.setMixWithOthers(true);
+  RoundTrip(mix, [](const MixWithOthersMessage &decoded, const char *layout) {
+    EXPECT(decoded.getMixWithOthers(), "%s", layout);
+  });
+
+  PreloadLimitMessage preload;
+  preload.setMaxPreloadedPlayers(2);
+  RoundTrip(preload,
+            [](const PreloadLimitMessage &decoded, const char *layout) {
+              EXPECT(decoded.getMaxPreloadedPlayers() == 2, "%s", layout);
+            });
+
+  PlaybackStatsIntervalMessage interval;
+  interval.setIntervalMs(500);
+  RoundTrip(interval, [](const PlaybackStatsIntervalMessage &decoded,
+                         const char *layout) {
+    EXPECT(decoded.getIntervalMs() == 500, "%s", layout);
+  });
+
+  BufferingThrottleMessage throttle;
+  throttle.setMinIntervalMs(250);
+  throttle.setMinPercentDelta(5);
+  RoundTrip(throttle,
+            [](const BufferingThrottleMessage &decoded, const char *layout) {
+              EXPECT(decoded.getMinIntervalMs() == 250, "%s", layout);
+              EXPECT(decoded.getMinPercentDelta() == 5, "%s", layout);
+            });
+}
+
+void TestListLayout() {
+  // The fields are in declaration order, as the Dart side sends them.
+  CreateMessage create;
+  create.setAsset("asset");
+  create.setUri("uri");
+  create.setPackageName("package");
+  create.setFormatHint("dash");
+  flutter::EncodableValue encoded = create.toList();
+  auto *list = std::get_if<flutter::EncodableList>(&encoded);
+  EXPECT(list && list->size() == 4, "CreateMessage has 4 fields");
+  if (list && list->size() == 4) {
+    EXPECT((*list)[0] == Value("asset"), "asset is field 0");
+    EXPECT((*list)[1] == Value("uri"), "uri is field 1");
+    EXPECT((*list)[2] == Value("package"), "packageName is field 2");
+    EXPECT((*list)[3] == Value("dash"), "formatHint is field 3");
+  }
+
+  // Dart sends small integers as int32.
+  flutter::EncodableList position = {flutter::EncodableValue(int32_t(7)),
+                                     flutter::EncodableValue(int32_t(1200))};
+  PositionMessage decoded =
+      PositionMessage::fromMap(flutter::EncodableValue(position));
+  EXPECT(decoded.getTextureId() == 7, "int32 textureId");
+  EXPECT(decoded.getPosition() == 1200, "int32 position");
+
+  // Missing, null and mistyped fields keep their defaults.
+  flutter::EncodableList looping = {flutter::EncodableValue(int64_t(1))};
+  LoopingMessage short_list =
+      LoopingMessage::fromMap(flutter::EncodableValue(looping));
+  EXPECT(short_list.getTextureId() == 1, "present field");
+  EXPECT(!short_list.getIsLooping(), "missing field");
+
+  flutter::EncodableList speed = {flutter::EncodableValue(),
+                                  flutter::EncodableValue("fast")};
+  PlaybackSpeedMessage mistyped =
+      PlaybackSpeedMessage::fromMap(flutter::EncodableValue(speed));
+  EXPECT(mistyped.getTextureId() == 0, "null field");
+  EXPECT(mistyped.getSpeed() == 1.0, "mistyped field");
+
+  TextureMessage empty = TextureMessage::fromMap(flutter::EncodableValue());
+  EXPECT(empty.getTextureId() == 0, "null message");
+}
+
+class FakeVideoPlayerApi : public VideoPlayerApi {
+ public:
+  void initialize() override {}
+  TextureMessage create(const CreateMessage &createMsg) override {
+    if (createMsg.getUri() == "invalid") {
+      throw VideoPlayerError("Invalid argument", "Unsupported uri");
+    }
+    last_create_ = createMsg;
+    TextureMessage result;
+    result.setTextureId(11);
+    return result;
+  }
+  void dispose(const TextureMessage &textureMsg) override {}
+  void setLooping(const LoopingMessage &loopingMsg) override {}
+  void setVolume(const VolumeMessage &volumeMsg) override {}
+  void setPlaybackSpeed(const PlaybackSpeedMessage &speedMsg) override {}
+  void play(const TextureMessage &textureMsg) override {}
+  void pause(const TextureMessage &textureMsg) override {}
+  PositionMessage position(const TextureMessage &textureMsg) override {
+    PositionMessage result;
+    result.setTextureId(textureMsg.getTextureId());
+    result.setPosition(3000);
+    return result;
+  }
+  void seekTo(const PositionMessage &positionMsg,
+              const SeekCompletedCb &onSeekCompleted) override {
+    last_seek_ = positionMsg;
+    onSeekCompleted();
+  }
+  void setMixWithOthers(const MixWithOthersMessage &mixWithOthersMsg) override {
+  }
+  void preload(const CreateMessage &createMsg) override {}
+  void setMaxPreloadedPlayers(
+      const PreloadLimitMessage &preloadLimitMsg) override {}
+  void setPlaybackStatsInterval(
+      const PlaybackStatsIntervalMessage &intervalMsg) override {}
+  void setBufferingThrottle(
+      const BufferingThrottleMessage &throttleMsg) override {}
+
+  CreateMessage last_create_;
+  PositionMessage last_seek_;
+};
+
+// Sends |message| to the VideoPlayerApi |method| and returns the reply, or a
+// null value if there was no reply.
+flutter::EncodableValue Call(const flutter::BinaryMessenger &messenger,
+                             const std::string &method,
+                             const flutter::EncodableValue &message) {
+  flutter::EncodableValue reply;
+  bool has_handler = messenger.Send(
+      kChannelPrefix + method, message,
+      [&reply](const flutter::EncodableValue &value) { reply = value; });
+  EXPECT(has_handler, "%s has a handler", method.c_str());
+  return reply;
+}
+
+void TestReplies() {
+  flutter::BinaryMessenger messenger;
+  FakeVideoPlayerApi api;
+  VideoPlayerApi::setup(&messenger, &api);
+
+  // A positional request is answered with [result].
+  CreateMessage create;
+  create.setUri("https://example.com/video.mp4");
+  create.setFormatHint("other");
+  flutter::EncodableValue reply = Call(messenger, "create", create.toList());
+  EXPECT(api.last_create_.getUri() == "https://example.com/video.mp4",
+         "create uri");
+  EXPECT(api.last_create_.getFormatHint() == "other", "create formatHint");
+  flutter::EncodableValue expected = flutter::EncodableList{
+      flutter::EncodableValue(flutter::EncodableList{
+          flutter::EncodableValue(int64_t(11))})};
+  EXPECT(reply == expected, "create replies [[textureId]]");
+
+  // A map request is answered with {"result": result}.
+  reply = Call(messenger, "create", create.toMap());
+  const flutter::EncodableValue *result = Find(reply, "result");
+  const flutter::EncodableValue *texture_id =
+      result ? Find(*result, "textureId") : nullptr;
+  EXPECT(texture_id && *texture_id == flutter::EncodableValue(int64_t(11)),
+         "create replies {result: {textureId}}");
+
+  // Methods without a result reply with [null].
+  flutter::EncodableList init_request;
+  reply = Call(messenger, "initialize", flutter::EncodableValue(init_request));
+  expected = flutter::EncodableList{flutter::EncodableValue()};
+  EXPECT(reply == expected, "initialize replies [null]");
+
+  TextureMessage texture;
+  texture.setTextureId(11);
+  reply = Call(messenger, "position", texture.toList());
+  expected = flutter::EncodableList{flutter::EncodableValue(
+      flutter::EncodableList{flutter::EncodableValue(int64_t(11)),
+                             flutter::EncodableValue(int64_t(3000))})};
+  EXPECT(reply == expected, "position replies [[textureId, position]]");
+
+  // seekTo replies from the completion callback, in the request layout.
+  PositionMessage seek;
+  seek.setTextureId(11);
+  seek.setPosition(4500);
+  reply = Call(messenger, "seekTo", seek.toList());
+  EXPECT(api.last_seek_.getPosition() == 4500, "seekTo position");
+  expected = flutter::EncodableList{flutter::EncodableValue()};
+  EXPECT(reply == expected, "seekTo replies [null]");
+  reply = Call(messenger, "seekTo", seek.toMap());
+  EXPECT(Find(reply, "result") && Find(reply, "result")->IsNull(),
+         "seekTo replies {result: null}");
+
+  // Errors are [code, message, details] or {"error": {...}}.
+  create.setUri("invalid");
+  reply = Call(messenger, "create", create.toList());
+  expected = flutter::EncodableList{Value("Invalid argument"),
+                                    Value("Unsupported uri"),
+                                    flutter::EncodableValue()};
+  EXPECT(reply == expected, "positional error");
+  reply = Call(messenger, "create", create.toMap());
+  const flutter::EncodableValue *error = Find(reply, "error");
+  EXPECT(error && Find(*error, "code") &&
+             *Find(*error, "code") == Value("Invalid argument"),
+         "map error code");
+  EXPECT(error && Find(*error, "message") &&
+             *Find(*error, "message") == Value("Unsupported uri"),
+         "map error message");
+}
+
+}  // namespace
+
+int main() {
+  TestRoundTrip();
+  TestListLayout();
+  TestReplies();
+  return ReportTestResult();
+}
@@ -31,6 +31,37 @@ class TizenWebView implements WebViewPlatform {
     WebView.platform = TizenWebView();
   }
 
+  static const MethodChannel _channel =
+      MethodChannel('plugins.flutter.io/webview_tizen');
+
+  /// Creates [count] web engine instances of the given [size] in the
+  /// background, so that the next [count] webviews start without paying the
+  /// engine startup cost.
+  static Future<void> prewarm(Size size, {int count = 1}) {
+    return _channel.invokeMethod<void>('prewarm', <String, dynamic>{
+      'count': count,
+      'width': size.width,
+      'height': size.height,
+    });
+  }
+
+  /// Sets the maximum number of rendering surfaces shared by all webviews.
+  ///
+  /// Each webview can always keep two surfaces, even beyond this limit.
+  static Future<void> setMaxSurfaces(int maxSurfaces) {
+    return _channel.invokeMethod<void>('setMaxSurfaces', <String, dynamic>{
+      'maxSurfaces': maxSurfaces,
+    });
+  }
+
+  /// Returns the `maxSurfaces`, `liveSurfaces` and `idleSurfaces` counts of
+  /// the surface pool shared by all webviews.
+  static Future<Map<String, int>> getSurfacePoolStats() async {
+    final Map<String, int>? stats =
+        await _channel.invokeMapMethod<String, int>('getSurfacePoolStats');
+    return stats ?? <String, int>{};
+  }
+
   @override
   Widget build({
     required BuildContext context,
@@ -47,6 +78,7 @@ class TizenWebView implements WebViewPlatform {
       child: TizenView(
         viewType: 'plugins.flutter.io/webview',
         onPlatformViewCreated: (int id) {
+          _setUpJavascriptChannelBatching(id, javascriptChannelRegistry);
           if (onWebViewPlatformCreated == null) {
             return;
           }
@@ -67,4 +99,25 @@ class TizenWebView implements WebViewPlatform {
 
   @override
   Future<bool> clearCookies() => MethodChannelWebViewPlatform.clearCookies();
+
+  /// Receives JavaScript channel messages that the platform side delivers in
+  /// batches once `setJavascriptChannelBatching` has been called on the
+  /// webview method channel.
+  static void _setUpJavascriptChannelBatching(
+      int id, JavascriptChannelRegistry javascriptChannelRegistry) {
+    final MethodChannel channel = MethodChannel(
+        'plugins.flutter.io/webview_$id/javascript_channel_messages');
+    channel.setMethodCallHandler((MethodCall call) async {
+      if (call.method != 'javascriptChannelMessages') {
+        throw MissingPluginException(
+            '${call.method} was invoked but has no handler');
+      }
+      final List<dynamic> messages = call.arguments as List<dynamic>;
+      for (final dynamic message in messages) {
+        javascriptChannelRegistry.onJavascriptChannelMessage(
+            message['channel']! as String, message['message']! as String);
+      }
+      return null;
+    });
+  }
 }
@@ -5,24 +5,28 @@
 #include "buffer_pool.h"
 
 #include "log.h"
+#include "surface_pool.h"
 
 #define BUFFER_POOL_SIZE 5
+#define MIN_ATTACHED_BUFFERS 2
 
 BufferUnit::BufferUnit(int index, int width, int height)
     : isUsed_(false),
       index_(index),
       width_(0),
       height_(0),
+      is_reset_pending_(false),
+      pending_width_(0),
+      pending_height_(0),
       tbm_surface_(nullptr),
       gpu_buffer_(nullptr) {
+  gpu_buffer_ = new FlutterDesktopGpuBuffer();
+  gpu_buffer_->buffer = nullptr;
   Reset(width, height);
 }
 
 BufferUnit::~BufferUnit() {
-  if (tbm_surface_) {
-    tbm_surface_destroy(tbm_surface_);
-    tbm_surface_ = nullptr;
-  }
+  Detach();
   if (gpu_buffer_) {
     delete gpu_buffer_;
     gpu_buffer_ = nullptr;
@@ -52,25 +56,57 @@ tbm_surface_h BufferUnit::Surface() {
 
 void BufferUnit::UnmarkInUse() { isUsed_ = false; }
 
-void BufferUnit::Reset(int width, int height) {
-  if (width_ == width && height_ == height) {
-    return;
+bool BufferUnit::Attach(bool reserved) {
+  if (tbm_surface_) {
+    return true;
   }
-  width_ = width;
-  height_ = height;
+  tbm_surface_ = SurfacePool::GetInstance().Acquire(width_, height_, reserved);
+  gpu_buffer_->buffer = tbm_surface_;
+  return tbm_surface_ != nullptr;
+}
+
+void BufferUnit::Detach() {
   if (tbm_surface_) {
-    tbm_surface_destroy(tbm_surface_);
+    SurfacePool::GetInstance().Return(tbm_surface_);
     tbm_surface_ = nullptr;
   }
   if (gpu_buffer_) {
-    delete gpu_buffer_;
-    gpu_buffer_ = nullptr;
+    gpu_buffer_->buffer = nullptr;
   }
-  tbm_surface_ = tbm_surface_create(width_, height_, TBM_FORMAT_ARGB8888);
-  gpu_buffer_ = new FlutterDesktopGpuBuffer();
+}
+
+bool BufferUnit::IsAttached() { return tbm_surface_ != nullptr; }
+
+void BufferUnit::Reset(int width, int height) {
+  is_reset_pending_ = false;
+  if (width_ == width && height_ == height) {
+    return;
+  }
+  bool was_attached = IsAttached();
+  Detach();
+  width_ = width;
+  height_ = height;
   gpu_buffer_->width = width_;
   gpu_buffer_->height = height_;
-  gpu_buffer_->buffer = tbm_surface_;
+  if (was_attached) {
+    // Not reserved, so that resizing respects the global cap. Prepare()
+    // attaches the reserved minimum afterwards.
+    Attach(false);
+  }
+}
+
+void BufferUnit::MarkForReset(int width, int height) {
+  is_reset_pending_ = true;
+  pending_width_ = width;
+  pending_height_ = height;
+}
+
+bool BufferUnit::IsResetPending() { return is_reset_pending_; }
+
+void BufferUnit::ApplyPendingReset() {
+  if (is_reset_pending_) {
+    Reset(pending_width_, pending_height_);
+  }
 }
 
 BufferPool::BufferPool(int width, int height) : last_index_(0) {
@@ -83,6 +119,7 @@ BufferPool::BufferPool(int width, int height) : last_index_(0) {
 BufferPool::~BufferPool() {}
 
 BufferUnit* BufferPool::Find(tbm_surface_h surface) {
+  std::lock_guard<std::mutex> lock(mutex_);
   for (int idx = 0; idx < pool_.size(); idx++) {
     BufferUnit* buffer = pool_[idx].get();
     if (buffer->Surface() == surface) {
@@ -94,10 +131,22 @@ BufferUnit* BufferPool::Find(tbm_surface_h surface) {
 
 BufferUnit* BufferPool::GetAvailableBuffer() {
   std::lock_guard<std::mutex> lock(mutex_);
+  // Prefer a unit that already holds a surface.
+  for (int idx = 0; idx < pool_.size(); idx++) {
+    int current = (idx + last_index_) % pool_.size();
+    BufferUnit* buffer = pool_[current].get();
+    if (buffer->IsAttached() && buffer->MarkInUse()) {
+      last_index_ = current;
+      return buffer;
+    }
+  }
+  // Otherwise borrow a surface from the shared pool.
   for (int idx = 0; idx < pool_.size(); idx++) {
     int current = (idx + last_index_) % pool_.size();
     BufferUnit* buffer = pool_[current].get();
-    if (buffer->MarkInUse()) {
+    if (!buffer->IsAttached() &&
+        buffer->Attach(AttachedCount() < MIN_ATTACHED_BUFFERS) &&
+        buffer->MarkInUse()) {
       last_index_ = current;
       return buffer;
     }
@@ -108,14 +157,40 @@ BufferUnit* BufferPool::GetAvailableBuffer() {
 void BufferPool::Release(BufferUnit* unit) {
   std::lock_guard<std::mutex> lock(mutex_);
   unit->UnmarkInUse();
+  unit->ApplyPendingReset();
+  if (AttachedCount() > MIN_ATTACHED_BUFFERS) {
+    unit->Detach();
+  }
 }
 
 void BufferPool::Prepare(int width, int height) {
   std::lock_guard<std::mutex> lock(mutex_);
   for (int idx = 0; idx < pool_.size(); idx++) {
     BufferUnit* buffer = pool_[idx].get();
+    if (buffer->IsUsed()) {
+      // The surface is on screen or being drawn into, so it cannot go back
+      // to the shared pool yet. Resize it when it is released.
+      buffer->MarkForReset(width, height);
+      continue;
+    }
     buffer->Reset(width, height);
   }
+  for (int idx = 0; idx < pool_.size(); idx++) {
+    if (AttachedCount() >= MIN_ATTACHED_BUFFERS) {
+      break;
+    }
+    pool_[idx]->Attach(true);
+  }
+}
+
+size_t BufferPool::AttachedCount() {
+  size_t count = 0;
+  for (int idx = 0; idx < pool_.size(); idx++) {
+    if (pool_[idx]->IsAttached()) {
+      count++;
+    }
+  }
+  return count;
 }
 
 #ifndef NDEBUG
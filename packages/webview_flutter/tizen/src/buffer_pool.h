@@ -18,6 +18,12 @@ class BufferUnit {
   explicit BufferUnit(int index, int width, int height);
   ~BufferUnit();
   void Reset(int width, int height);
+  void MarkForReset(int width, int height);
+  bool IsResetPending();
+  void ApplyPendingReset();
+  bool Attach(bool reserved);
+  void Detach();
+  bool IsAttached();
   bool MarkInUse();
   void UnmarkInUse();
   int Index();
@@ -33,6 +39,9 @@ class BufferUnit {
   int index_;
   int width_;
   int height_;
+  bool is_reset_pending_;
+  int pending_width_;
+  int pending_height_;
   tbm_surface_h tbm_surface_;
   FlutterDesktopGpuBuffer* gpu_buffer_;
 };
@@ -48,6 +57,8 @@ class BufferPool {
   void Prepare(int with, int height);
 
  private:
+  size_t AttachedCount();
+
   int last_index_;
   std::mutex mutex_;
   std::vector<std::unique_ptr<BufferUnit>> pool_;
@@ -0,0 +1,112 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "frame_timings.h"
+
+#include <trace.h>
+
+#define TRACE_FRAME_NAME "WebView frame"
+#define TRACE_DROPPED_NAME "WebView dropped frames"
+#define TRACE_EXHAUSTED_NAME "WebView pool exhausted"
+
+FrameTimings::FrameTimings() : trace_enabled_(false) { Reset(); }
+
+void FrameTimings::OnFrameRendered() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_rendered_++;
+  last_rendered_time_ = Clock::now();
+  if (trace_enabled_) {
+    trace_async_begin(static_cast<int>(frames_rendered_), TRACE_FRAME_NAME);
+  }
+}
+
+void FrameTimings::OnFrameDropped() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_dropped_++;
+  if (trace_enabled_) {
+    trace_async_end(static_cast<int>(frames_rendered_), TRACE_FRAME_NAME);
+    trace_update_counter(static_cast<int>(frames_dropped_),
+                         TRACE_DROPPED_NAME);
+  }
+}
+
+void FrameTimings::OnFramePresented() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_presented_++;
+  int64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           Clock::now() - last_rendered_time_)
+                           .count();
+  latency_sum_us_ += latency_us;
+  if (latency_us > latency_max_us_) {
+    latency_max_us_ = latency_us;
+  }
+  size_t bucket = 0;
+  while (bucket < kBucketBounds.size() && latency_us > kBucketBounds[bucket]) {
+    bucket++;
+  }
+  latency_histogram_[bucket]++;
+  if (trace_enabled_) {
+    trace_async_end(static_cast<int>(frames_rendered_), TRACE_FRAME_NAME);
+  }
+}
+
+void FrameTimings::OnPoolExhausted() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pool_exhausted_++;
+  if (trace_enabled_) {
+    trace_update_counter(static_cast<int>(pool_exhausted_),
+                         TRACE_EXHAUSTED_NAME);
+  }
+}
+
+void FrameTimings::SetTraceEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  trace_enabled_ = enabled;
+}
+
+void FrameTimings::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  frames_rendered_ = 0;
+  frames_presented_ = 0;
+  frames_dropped_ = 0;
+  pool_exhausted_ = 0;
+  latency_sum_us_ = 0;
+  latency_max_us_ = 0;
+  latency_histogram_.fill(0);
+  last_rendered_time_ = Clock::now();
+}
+
+flutter::EncodableMap FrameTimings::ToEncodableMap() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  flutter::EncodableList histogram;
+  for (int64_t count : latency_histogram_) {
+    histogram.push_back(flutter::EncodableValue(count));
+  }
+  flutter::EncodableList bounds;
+  for (int64_t bound : kBucketBounds) {
+    bounds.push_back(flutter::EncodableValue(bound));
+  }
+  int64_t latency_avg_us =
+      frames_presented_ > 0 ? latency_sum_us_ / frames_presented_ : 0;
+
+  flutter::EncodableMap map = {
+      {flutter::EncodableValue("framesRendered"),
+       flutter::EncodableValue(frames_rendered_)},
+      {flutter::EncodableValue("framesPresented"),
+       flutter::EncodableValue(frames_presented_)},
+      {flutter::EncodableValue("framesDropped"),
+       flutter::EncodableValue(frames_dropped_)},
+      {flutter::EncodableValue("poolExhausted"),
+       flutter::EncodableValue(pool_exhausted_)},
+      {flutter::EncodableValue("latencyAvgUs"),
+       flutter::EncodableValue(latency_avg_us)},
+      {flutter::EncodableValue("latencyMaxUs"),
+       flutter::EncodableValue(latency_max_us_)},
+      {flutter::EncodableValue("latencyBucketBoundsUs"),
+       flutter::EncodableValue(bounds)},
+      {flutter::EncodableValue("latencyHistogram"),
+       flutter::EncodableValue(histogram)},
+  };
+  return map;
+}
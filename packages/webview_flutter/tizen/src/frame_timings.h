@@ -0,0 +1,53 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_FRAME_TIMINGS_H_
+#define FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_FRAME_TIMINGS_H_
+
+#include <flutter/encodable_value.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Collects per-WebView frame statistics.
+//
+// A frame is "rendered" when LWE flushes it into a surface and "presented"
+// when the raster thread picks it up in ObtainGpuBuffer. A rendered frame
+// that is replaced before being presented is counted as dropped.
+class FrameTimings {
+ public:
+  FrameTimings();
+
+  void OnFrameRendered();
+  void OnFrameDropped();
+  void OnFramePresented();
+  void OnPoolExhausted();
+
+  void SetTraceEnabled(bool enabled);
+  void Reset();
+  flutter::EncodableMap ToEncodableMap();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  // Upper bounds (in microseconds) of the latency histogram buckets. The last
+  // bucket collects everything above the last bound.
+  static constexpr std::array<int64_t, 7> kBucketBounds = {
+      1000, 2000, 4000, 8000, 16000, 33000, 66000};
+
+  std::mutex mutex_;
+  bool trace_enabled_;
+  int64_t frames_rendered_;
+  int64_t frames_presented_;
+  int64_t frames_dropped_;
+  int64_t pool_exhausted_;
+  int64_t latency_sum_us_;
+  int64_t latency_max_us_;
+  std::array<int64_t, kBucketBounds.size() + 1> latency_histogram_;
+  Clock::time_point last_rendered_time_;
+};
+
+#endif  // FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_FRAME_TIMINGS_H_
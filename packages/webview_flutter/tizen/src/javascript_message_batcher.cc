@@ -0,0 +1,73 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "javascript_message_batcher.h"
+
+#include "log.h"
+
+JavaScriptMessageBatcher::JavaScriptMessageBatcher(FlushCallback on_flush)
+    : on_flush_(on_flush),
+      enabled_(false),
+      max_delay_ms_(0),
+      max_entries_(0),
+      timer_(nullptr) {}
+
+JavaScriptMessageBatcher::~JavaScriptMessageBatcher() {
+  if (timer_) {
+    ecore_timer_del(timer_);
+    timer_ = nullptr;
+  }
+}
+
+bool JavaScriptMessageBatcher::Configure(int max_delay_ms, int max_entries) {
+  LOG_DEBUG("Configure(max_delay_ms: %d, max_entries: %d)\n", max_delay_ms,
+            max_entries);
+  if (max_delay_ms <= 0 && max_entries > 1) {
+    return false;
+  }
+  // Deliver whatever was gathered with the previous configuration.
+  Flush();
+  enabled_ = max_delay_ms > 0;
+  max_delay_ms_ = max_delay_ms;
+  max_entries_ = max_entries;
+  return true;
+}
+
+bool JavaScriptMessageBatcher::IsEnabled() { return enabled_; }
+
+void JavaScriptMessageBatcher::Add(const std::string& channel,
+                                   const std::string& message) {
+  flutter::EncodableMap map = {
+      {flutter::EncodableValue("channel"), flutter::EncodableValue(channel)},
+      {flutter::EncodableValue("message"), flutter::EncodableValue(message)},
+  };
+  pending_messages_.push_back(flutter::EncodableValue(map));
+  if (max_entries_ > 0 &&
+      pending_messages_.size() >= static_cast<size_t>(max_entries_)) {
+    Flush();
+  } else if (!timer_) {
+    timer_ = ecore_timer_add(max_delay_ms_ / 1000.0, OnTimer, this);
+  }
+}
+
+void JavaScriptMessageBatcher::Flush() {
+  if (timer_) {
+    ecore_timer_del(timer_);
+    timer_ = nullptr;
+  }
+  if (pending_messages_.empty()) {
+    return;
+  }
+  flutter::EncodableList messages;
+  messages.swap(pending_messages_);
+  on_flush_(std::move(messages));
+}
+
+Eina_Bool JavaScriptMessageBatcher::OnTimer(void* data) {
+  auto* self = static_cast<JavaScriptMessageBatcher*>(data);
+  // The timer is deleted when this callback returns ECORE_CALLBACK_CANCEL.
+  self->timer_ = nullptr;
+  self->Flush();
+  return ECORE_CALLBACK_CANCEL;
+}
@@ -0,0 +1,49 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_JAVASCRIPT_MESSAGE_BATCHER_H_
+#define FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_JAVASCRIPT_MESSAGE_BATCHER_H_
+
+#include <Ecore.h>
+#include <flutter/encodable_value.h>
+
+#include <functional>
+#include <string>
+
+// Gathers JavaScript channel messages and delivers them as a single list,
+// either when |max_entries| messages are pending or |max_delay_ms|
+// milliseconds after the first pending message, whichever comes first.
+// Messages are delivered in the order they were posted.
+//
+// LWE invokes JavaScript channel callbacks on the platform thread, so this
+// class is only used on the platform thread and is not thread-safe.
+class JavaScriptMessageBatcher {
+ public:
+  using FlushCallback = std::function<void(flutter::EncodableList messages)>;
+
+  explicit JavaScriptMessageBatcher(FlushCallback on_flush);
+  ~JavaScriptMessageBatcher();
+
+  // Batching is disabled when |max_delay_ms| is zero and |max_entries| is
+  // at most one. Returns false without changing the configuration if only
+  // |max_entries| is set, because messages would then wait indefinitely.
+  bool Configure(int max_delay_ms, int max_entries);
+  bool IsEnabled();
+
+  void Add(const std::string& channel, const std::string& message);
+  void Flush();
+
+ private:
+  static Eina_Bool OnTimer(void* data);
+
+  FlushCallback on_flush_;
+  flutter::EncodableList pending_messages_;
+  bool enabled_;
+  int max_delay_ms_;
+  int max_entries_;
+  // Armed by the first pending message and deleted by Flush().
+  Ecore_Timer* timer_;
+};
+
+#endif  // FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_JAVASCRIPT_MESSAGE_BATCHER_H_
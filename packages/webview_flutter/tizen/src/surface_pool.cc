@@ -0,0 +1,112 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "surface_pool.h"
+
+#include "log.h"
+
+#define DEFAULT_MAX_SURFACES 12
+#define MAX_IDLE_SURFACES 4
+
+SurfacePool& SurfacePool::GetInstance() {
+  // Intentionally leaked: destroying tbm surfaces during static destruction
+  // may run after the tbm bufmgr is gone. The process exit frees them.
+  static SurfacePool* instance = new SurfacePool();
+  return *instance;
+}
+
+SurfacePool::SurfacePool()
+    : max_surfaces_(DEFAULT_MAX_SURFACES), live_count_(0), idle_count_(0) {}
+
+SurfacePool::SizeClass SurfacePool::GetSizeClass(int width, int height) {
+  // LWE always renders into the whole surface and the surface size is what
+  // the texture reports to the engine, so a size class is an exact size.
+  return std::make_pair(width, height);
+}
+
+tbm_surface_h SurfacePool::Acquire(int width, int height, bool reserved) {
+  if (width <= 0 || height <= 0) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = idle_surfaces_.find(GetSizeClass(width, height));
+  if (iter != idle_surfaces_.end() && !iter->second.empty()) {
+    tbm_surface_h surface = iter->second.back();
+    iter->second.pop_back();
+    idle_count_--;
+    return surface;
+  }
+
+  if (live_count_ >= max_surfaces_ && !EvictIdleSurface() && !reserved) {
+    LOG_DEBUG("Surface pool exhausted (live: %zu, max: %zu)\n", live_count_,
+              max_surfaces_);
+    return nullptr;
+  }
+
+  tbm_surface_h surface =
+      tbm_surface_create(width, height, TBM_FORMAT_ARGB8888);
+  if (!surface) {
+    LOG_ERROR("Failed to create a tbm surface (%dx%d)\n", width, height);
+    return nullptr;
+  }
+  live_count_++;
+  return surface;
+}
+
+void SurfacePool::Return(tbm_surface_h surface) {
+  if (!surface) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (idle_count_ >= MAX_IDLE_SURFACES || live_count_ > max_surfaces_) {
+    tbm_surface_destroy(surface);
+    live_count_--;
+    return;
+  }
+  SizeClass size_class = GetSizeClass(tbm_surface_get_width(surface),
+                                      tbm_surface_get_height(surface));
+  idle_surfaces_[size_class].push_back(surface);
+  idle_count_++;
+}
+
+void SurfacePool::SetMaxSurfaces(size_t max_surfaces) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  max_surfaces_ = max_surfaces;
+  while (live_count_ > max_surfaces_ && EvictIdleSurface()) {
+  }
+}
+
+size_t SurfacePool::MaxSurfaces() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return max_surfaces_;
+}
+
+size_t SurfacePool::LiveCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return live_count_;
+}
+
+size_t SurfacePool::IdleCount() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return idle_count_;
+}
+
+bool SurfacePool::EvictIdleSurface() {
+  for (auto iter = idle_surfaces_.begin(); iter != idle_surfaces_.end();
+       iter++) {
+    if (!iter->second.empty()) {
+      tbm_surface_destroy(iter->second.back());
+      iter->second.pop_back();
+      if (iter->second.empty()) {
+        idle_surfaces_.erase(iter);
+      }
+      idle_count_--;
+      live_count_--;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,49 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_SURFACE_POOL_H_
+#define FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_SURFACE_POOL_H_
+
+#include <tbm_surface.h>
+
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// A process-wide allocator of tbm surfaces shared by all WebView instances.
+//
+// Idle surfaces are kept in buckets keyed by their size class so that a
+// surface returned by one view can be handed out to any other view of the
+// same size without reallocating. The total number of live surfaces is
+// bounded by a global cap; reserved requests (used for the per-view minimum)
+// are always served so that every view can keep rendering.
+class SurfacePool {
+ public:
+  static SurfacePool& GetInstance();
+
+  tbm_surface_h Acquire(int width, int height, bool reserved);
+  void Return(tbm_surface_h surface);
+
+  void SetMaxSurfaces(size_t max_surfaces);
+  size_t MaxSurfaces();
+  size_t LiveCount();
+  size_t IdleCount();
+
+ private:
+  using SizeClass = std::pair<int, int>;
+
+  SurfacePool();
+
+  static SizeClass GetSizeClass(int width, int height);
+  bool EvictIdleSurface();
+
+  std::mutex mutex_;
+  std::map<SizeClass, std::vector<tbm_surface_h>> idle_surfaces_;
+  size_t max_surfaces_;
+  size_t live_count_;
+  size_t idle_count_;
+};
+
+#endif  // FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_SURFACE_POOL_H_
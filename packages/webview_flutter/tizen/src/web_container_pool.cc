@@ -0,0 +1,122 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "web_container_pool.h"
+
+#include "buffer_pool.h"
+#include "log.h"
+#include "lwe/LWEWebView.h"
+#include "webview.h"
+
+#define LWE_EXPORT
+extern "C" size_t LWE_EXPORT createWebViewInstance(
+    unsigned x, unsigned y, unsigned width, unsigned height,
+    float devicePixelRatio, const char* defaultFontName, const char* locale,
+    const char* timezoneID,
+    const std::function<::LWE::WebContainer::ExternalImageInfo(void)>&
+        prepareImageCb,
+    const std::function<void(::LWE::WebContainer*, bool needsFlush)>& flushCb,
+    bool useSWBackend);
+
+void WebContainerBinding::Bind(WebView* view) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  view_ = view;
+}
+
+void* WebContainerBinding::PrepareImage() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!view_) {
+    return nullptr;
+  }
+  return view_->PrepareImage();
+}
+
+void WebContainerBinding::OnFlush(bool is_rendered) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (view_) {
+    view_->OnFlush(is_rendered);
+  }
+}
+
+WebContainerPool::WebContainerPool()
+    : idler_(nullptr), pending_count_(0), width_(0), height_(0) {}
+
+WebContainerPool::~WebContainerPool() { Clear(); }
+
+std::unique_ptr<WebContainerEntry> WebContainerPool::CreateEntry(
+    double width, double height) {
+  auto entry = std::make_unique<WebContainerEntry>();
+  entry->width = width;
+  entry->height = height;
+  entry->buffer_pool = std::make_unique<BufferPool>(width, height);
+  entry->binding = std::make_shared<WebContainerBinding>();
+
+  float scale_factor = 1;
+  std::shared_ptr<WebContainerBinding> binding = entry->binding;
+  entry->container = (LWE::WebContainer*)createWebViewInstance(
+      0, 0, width, height, scale_factor, "SamsungOneUI", "ko-KR", "Asia/Seoul",
+      [binding]() -> LWE::WebContainer::ExternalImageInfo {
+        LWE::WebContainer::ExternalImageInfo result;
+        result.imageAddress = binding->PrepareImage();
+        return result;
+      },
+      [binding](LWE::WebContainer* c, bool isRendered) {
+        binding->OnFlush(isRendered);
+      },
+      false);
+#ifndef TV_PROFILE
+  auto settings = entry->container->GetSettings();
+  settings.SetUserAgentString(
+      "Mozilla/5.0 (like Gecko/54.0 Firefox/54.0) Mobile");
+  entry->container->SetSettings(settings);
+#endif
+  return entry;
+}
+
+void WebContainerPool::Prewarm(int count, double width, double height) {
+  LOG_DEBUG("Prewarm(count: %d, width: %f, height: %f)\n", count, width,
+            height);
+  if (width != width_ || height != height_) {
+    // Containers of another size would have to be resized right away.
+    Clear();
+    width_ = width;
+    height_ = height;
+  }
+  pending_count_ = count - static_cast<int>(entries_.size());
+  if (pending_count_ > 0 && !idler_) {
+    idler_ = ecore_idler_add(OnIdle, this);
+  }
+}
+
+Eina_Bool WebContainerPool::OnIdle(void* data) {
+  auto* self = static_cast<WebContainerPool*>(data);
+  if (self->pending_count_ <= 0) {
+    self->idler_ = nullptr;
+    return ECORE_CALLBACK_CANCEL;
+  }
+  self->entries_.push_back(CreateEntry(self->width_, self->height_));
+  self->pending_count_--;
+  return ECORE_CALLBACK_RENEW;
+}
+
+std::unique_ptr<WebContainerEntry> WebContainerPool::Take() {
+  if (entries_.empty()) {
+    return nullptr;
+  }
+  std::unique_ptr<WebContainerEntry> entry = std::move(entries_.front());
+  entries_.erase(entries_.begin());
+  return entry;
+}
+
+void WebContainerPool::Clear() {
+  if (idler_) {
+    ecore_idler_del(idler_);
+    idler_ = nullptr;
+  }
+  pending_count_ = 0;
+  for (auto& entry : entries_) {
+    entry->container->Destroy();
+  }
+  entries_.clear();
+}
@@ -0,0 +1,68 @@
+// Copyright 2021 Samsung Electronics Co., Ltd. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_WEB_CONTAINER_POOL_H_
+#define FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_WEB_CONTAINER_POOL_H_
+
+#include <Ecore.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace LWE {
+class WebContainer;
+}
+
+class BufferPool;
+class WebView;
+
+// Forwards the render callbacks of an LWE container to the WebView that
+// currently owns it. A container created ahead of time is not bound to any
+// view until it is handed out.
+class WebContainerBinding {
+ public:
+  void Bind(WebView* view);
+  void* PrepareImage();
+  void OnFlush(bool is_rendered);
+
+ private:
+  std::mutex mutex_;
+  WebView* view_ = nullptr;
+};
+
+struct WebContainerEntry {
+  LWE::WebContainer* container = nullptr;
+  std::unique_ptr<BufferPool> buffer_pool;
+  std::shared_ptr<WebContainerBinding> binding;
+  double width = 0;
+  double height = 0;
+};
+
+// Keeps LWE containers that were created before any WebView asked for one,
+// so that the engine startup cost is not paid on the first navigation.
+class WebContainerPool {
+ public:
+  WebContainerPool();
+  ~WebContainerPool();
+
+  static std::unique_ptr<WebContainerEntry> CreateEntry(double width,
+                                                        double height);
+
+  // Creates |count| containers from the main loop idler, one per iteration.
+  void Prewarm(int count, double width, double height);
+  std::unique_ptr<WebContainerEntry> Take();
+  void Clear();
+
+ private:
+  static Eina_Bool OnIdle(void* data);
+
+  std::vector<std::unique_ptr<WebContainerEntry>> entries_;
+  Ecore_Idler* idler_;
+  int pending_count_;
+  double width_;
+  double height_;
+};
+
+#endif  // FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEBVIEW_WEB_CONTAINER_POOL_H_
@@ -16,21 +16,14 @@
 #include <string>
 
 #include "buffer_pool.h"
+#include "frame_timings.h"
+#include "javascript_message_batcher.h"
 #include "log.h"
 #include "lwe/LWEWebView.h"
 #include "lwe/PlatformIntegrationData.h"
+#include "web_container_pool.h"
 #include "webview_factory.h"
 
-#define LWE_EXPORT
-extern "C" size_t LWE_EXPORT createWebViewInstance(
-    unsigned x, unsigned y, unsigned width, unsigned height,
-    float devicePixelRatio, const char* defaultFontName, const char* locale,
-    const char* timezoneID,
-    const std::function<::LWE::WebContainer::ExternalImageInfo(void)>&
-        prepareImageCb,
-    const std::function<void(::LWE::WebContainer*, bool needsFlush)>& flushCb,
-    bool useSWBackend);
-
 template <typename T = flutter::EncodableValue>
 class NavigationRequestResult : public flutter::MethodResult<T> {
  public:
@@ -144,7 +137,8 @@ bool GetValueFromEncodableMap(const flutter::EncodableValue& arguments,
 WebView::WebView(flutter::PluginRegistrar* registrar, int viewId,
                  flutter::TextureRegistrar* texture_registrar, double width,
                  double height, flutter::EncodableMap& params,
-                 void* platform_window)
+                 void* platform_window,
+                 std::unique_ptr<WebContainerEntry> prewarmed_container)
     : PlatformView(registrar, viewId, platform_window),
       texture_registrar_(texture_registrar),
       webview_instance_(nullptr),
@@ -154,19 +148,23 @@ WebView::WebView(flutter::PluginRegistrar* registrar, int viewId,
       candidate_surface_(nullptr),
       rendered_surface_(nullptr),
       is_mouse_lbutton_down_(false),
+      has_pending_mouse_move_(false),
+      pending_mouse_move_x_(0),
+      pending_mouse_move_y_(0),
+      mouse_move_animator_(nullptr),
       has_navigation_delegate_(false),
       has_progress_tracking_(false),
       context_(nullptr),
       texture_variant_(nullptr),
       platform_window_(platform_window) {
-  tbm_pool_ = std::make_unique<BufferPool>(width, height);
+  frame_timings_ = std::make_unique<FrameTimings>();
   texture_variant_ = new flutter::TextureVariant(flutter::GpuBufferTexture(
       [this](size_t width, size_t height) -> const FlutterDesktopGpuBuffer* {
         return this->ObtainGpuBuffer(width, height);
       },
       [this](void* buffer) -> void { this->DestructBuffer(buffer); }));
   SetTextureId(texture_registrar_->RegisterTexture(texture_variant_));
-  InitWebView();
+  InitWebView(std::move(prewarmed_container));
 
   channel_ = std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
       GetPluginRegistrar()->messenger(), GetChannelName(),
@@ -176,6 +174,18 @@ WebView::WebView(flutter::PluginRegistrar* registrar, int viewId,
         webview->HandleMethodCall(call, std::move(result));
       });
 
+  javascript_batch_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          GetPluginRegistrar()->messenger(),
+          GetChannelName() + "/javascript_channel_messages",
+          &flutter::StandardMethodCodec::GetInstance());
+  javascript_message_batcher_ = std::make_unique<JavaScriptMessageBatcher>(
+      [this](flutter::EncodableList messages) {
+        auto args = std::make_unique<flutter::EncodableValue>(messages);
+        javascript_batch_channel_->InvokeMethod("javascriptChannelMessages",
+                                                std::move(args));
+      });
+
   auto cookie_channel =
       std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
           GetPluginRegistrar()->messenger(),
@@ -354,6 +364,10 @@ void WebView::RegisterJavaScriptChannelName(const std::string& name) {
   std::function<std::string(const std::string&)> cb =
       [this, name](const std::string& message) -> std::string {
     LOG_DEBUG("Invoke JavaScriptChannel(message: %s)\n", message.c_str());
+    if (javascript_message_batcher_->IsEnabled()) {
+      javascript_message_batcher_->Add(name, message);
+      return "success";
+    }
     flutter::EncodableMap map;
     map.insert(std::make_pair<flutter::EncodableValue, flutter::EncodableValue>(
         flutter::EncodableValue("channel"), flutter::EncodableValue(name)));
@@ -378,11 +392,27 @@ std::string WebView::GetChannelName() {
 void WebView::Dispose() {
   texture_registrar_->UnregisterTexture(GetTextureId());
 
+  if (mouse_move_animator_) {
+    ecore_animator_del(mouse_move_animator_);
+    mouse_move_animator_ = nullptr;
+  }
+  has_pending_mouse_move_ = false;
+
+  if (container_binding_) {
+    container_binding_->Bind(nullptr);
+    container_binding_ = nullptr;
+  }
+
   if (webview_instance_) {
     webview_instance_->Destroy();
     webview_instance_ = nullptr;
   }
 
+  if (javascript_message_batcher_) {
+    javascript_message_batcher_->Flush();
+    javascript_message_batcher_ = nullptr;
+  }
+
   if (texture_variant_) {
     delete texture_variant_;
     texture_variant_ = nullptr;
@@ -394,8 +424,12 @@ void WebView::Resize(double width, double height) {
   width_ = width;
   height_ = height;
 
-  if (candidate_surface_) {
-    candidate_surface_ = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (candidate_surface_) {
+      tbm_pool_->Release(candidate_surface_);
+      candidate_surface_ = nullptr;
+    }
   }
   tbm_pool_->Prepare(width_, height_);
   webview_instance_->ResizeTo(width_, height_);
@@ -404,18 +438,31 @@ void WebView::Resize(double width, double height) {
 void WebView::Touch(int type, int button, double x, double y, double dx,
                     double dy) {
   if (type == 0) {  // down event
+    FlushPendingMouseMoveEvent();
     webview_instance_->DispatchMouseDownEvent(
         LWE::MouseButtonValue::LeftButton,
         LWE::MouseButtonsValue::LeftButtonDown, x, y);
     is_mouse_lbutton_down_ = true;
   } else if (type == 1) {  // move event
-    webview_instance_->DispatchMouseMoveEvent(
-        is_mouse_lbutton_down_ ? LWE::MouseButtonValue::LeftButton
-                               : LWE::MouseButtonValue::NoButton,
-        is_mouse_lbutton_down_ ? LWE::MouseButtonsValue::LeftButtonDown
-                               : LWE::MouseButtonsValue::NoButtonDown,
-        x, y);
+    // Only the latest position is delivered once per animator tick (vsync).
+    pending_mouse_move_x_ = x;
+    pending_mouse_move_y_ = y;
+    has_pending_mouse_move_ = true;
+    if (!mouse_move_animator_) {
+      mouse_move_animator_ = ecore_animator_add(
+          [](void* data) -> Eina_Bool {
+            WebView* view = static_cast<WebView*>(data);
+            view->mouse_move_animator_ = nullptr;
+            view->FlushPendingMouseMoveEvent();
+            return ECORE_CALLBACK_CANCEL;
+          },
+          this);
+      if (!mouse_move_animator_) {
+        FlushPendingMouseMoveEvent();
+      }
+    }
   } else if (type == 2) {  // up event
+    FlushPendingMouseMoveEvent();
     webview_instance_->DispatchMouseUpEvent(
         LWE::MouseButtonValue::NoButton, LWE::MouseButtonsValue::NoButtonDown,
         x, y);
@@ -425,6 +472,28 @@ void WebView::Touch(int type, int button, double x, double y, double dx,
   }
 }
 
+void WebView::DispatchMouseMoveEvent(double x, double y) {
+  webview_instance_->DispatchMouseMoveEvent(
+      is_mouse_lbutton_down_ ? LWE::MouseButtonValue::LeftButton
+                             : LWE::MouseButtonValue::NoButton,
+      is_mouse_lbutton_down_ ? LWE::MouseButtonsValue::LeftButtonDown
+                             : LWE::MouseButtonsValue::NoButtonDown,
+      x, y);
+}
+
+void WebView::FlushPendingMouseMoveEvent() {
+  if (mouse_move_animator_) {
+    ecore_animator_del(mouse_move_animator_);
+    mouse_move_animator_ = nullptr;
+  }
+  if (has_pending_mouse_move_) {
+    has_pending_mouse_move_ = false;
+    if (webview_instance_) {
+      DispatchMouseMoveEvent(pending_mouse_move_x_, pending_mouse_move_y_);
+    }
+  }
+}
+
 static LWE::KeyValue EcoreEventKeyToKeyValue(const char* ecore_key_string,
                                              bool is_shift_pressed) {
   if (strcmp("Left", ecore_key_string) == 0) {
@@ -755,50 +824,61 @@ void WebView::SetDirection(int direction) {
   // TODO: implement this if necessary
 }
 
-void WebView::InitWebView() {
+void WebView::InitWebView(
+    std::unique_ptr<WebContainerEntry> prewarmed_container) {
+  if (container_binding_) {
+    container_binding_->Bind(nullptr);
+    container_binding_ = nullptr;
+  }
   if (webview_instance_ != nullptr) {
     webview_instance_->Destroy();
     webview_instance_ = nullptr;
   }
 
-  float scale_factor = 1;
+  std::unique_ptr<WebContainerEntry> entry = std::move(prewarmed_container);
+  if (!entry) {
+    entry = WebContainerPool::CreateEntry(width_, height_);
+  }
+  webview_instance_ = entry->container;
+  tbm_pool_ = std::move(entry->buffer_pool);
+  container_binding_ = entry->binding;
+  container_binding_->Bind(this);
+
+  if (entry->width != width_ || entry->height != height_) {
+    tbm_pool_->Prepare(width_, height_);
+    webview_instance_->ResizeTo(width_, height_);
+  }
+}
 
-  webview_instance_ = (LWE::WebContainer*)createWebViewInstance(
-      0, 0, width_, height_, scale_factor, "SamsungOneUI", "ko-KR",
-      "Asia/Seoul",
-      [this]() -> LWE::WebContainer::ExternalImageInfo {
-        std::lock_guard<std::mutex> lock(mutex_);
-        LWE::WebContainer::ExternalImageInfo result;
-        if (!working_surface_) {
-          working_surface_ = tbm_pool_->GetAvailableBuffer();
-        }
-        if (working_surface_) {
-          result.imageAddress = static_cast<void*>(working_surface_->Surface());
-        } else {
-          result.imageAddress = nullptr;
-        }
-        return result;
-      },
-      [this](LWE::WebContainer* c, bool isRendered) {
-        if (isRendered) {
-          std::lock_guard<std::mutex> lock(mutex_);
-          if (candidate_surface_) {
-            tbm_pool_->Release(candidate_surface_);
-            candidate_surface_ = nullptr;
-          } else {
-            texture_registrar_->MarkTextureFrameAvailable(GetTextureId());
-          }
-          candidate_surface_ = working_surface_;
-          working_surface_ = nullptr;
-        }
-      },
-      false);
-#ifndef TV_PROFILE
-  auto settings = webview_instance_->GetSettings();
-  settings.SetUserAgentString(
-      "Mozilla/5.0 (like Gecko/54.0 Firefox/54.0) Mobile");
-  webview_instance_->SetSettings(settings);
-#endif
+void* WebView::PrepareImage() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!working_surface_) {
+    working_surface_ = tbm_pool_->GetAvailableBuffer();
+  }
+  if (working_surface_) {
+    return static_cast<void*>(working_surface_->Surface());
+  }
+  frame_timings_->OnPoolExhausted();
+  return nullptr;
+}
+
+void WebView::OnFlush(bool is_rendered) {
+  if (is_rendered) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!working_surface_) {
+      return;
+    }
+    if (candidate_surface_) {
+      frame_timings_->OnFrameDropped();
+      tbm_pool_->Release(candidate_surface_);
+      candidate_surface_ = nullptr;
+    } else {
+      texture_registrar_->MarkTextureFrameAvailable(GetTextureId());
+    }
+    candidate_surface_ = working_surface_;
+    working_surface_ = nullptr;
+    frame_timings_->OnFrameRendered();
+  }
 }
 
 void WebView::HandleMethodCall(
@@ -920,6 +1000,34 @@ void WebView::HandleMethodCall(
     result->Success(flutter::EncodableValue(webview_instance_->GetScrollX()));
   } else if (method_name.compare("getScrollY") == 0) {
     result->Success(flutter::EncodableValue(webview_instance_->GetScrollY()));
+  } else if (method_name.compare("setJavascriptChannelBatching") == 0) {
+    int max_delay_ms = 0, max_entries = 0;
+    GetValueFromEncodableMap(arguments, "maxDelayMs", &max_delay_ms);
+    GetValueFromEncodableMap(arguments, "maxEntries", &max_entries);
+    if (max_delay_ms < 0 || max_entries < 0) {
+      result->Error("InvalidArguments",
+                    "Please set 'maxDelayMs' or 'maxEntries' properly");
+      return;
+    }
+    if (!javascript_message_batcher_->Configure(max_delay_ms, max_entries)) {
+      result->Error("InvalidArguments",
+                    "'maxEntries' requires a positive 'maxDelayMs'");
+      return;
+    }
+    result->Success();
+  } else if (method_name.compare("getFrameTimings") == 0) {
+    result->Success(flutter::EncodableValue(frame_timings_->ToEncodableMap()));
+    bool reset = false;
+    if (GetValueFromEncodableMap(arguments, "reset", &reset) && reset) {
+      frame_timings_->Reset();
+    }
+  } else if (method_name.compare("setFrameTimingTraceEnabled") == 0) {
+    if (std::holds_alternative<bool>(arguments)) {
+      frame_timings_->SetTraceEnabled(std::get<bool>(arguments));
+      result->Success();
+      return;
+    }
+    result->Error("InvalidArguments", "Please set a bool value");
   } else {
     result->NotImplemented();
   }
@@ -959,6 +1067,7 @@ FlutterDesktopGpuBuffer* WebView::ObtainGpuBuffer(size_t width, size_t height) {
   }
   rendered_surface_ = candidate_surface_;
   candidate_surface_ = nullptr;
+  frame_timings_->OnFramePresented();
   return rendered_surface_->GpuBuffer();
 }
 
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEVIEW_H_
 #define FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEVIEW_H_
 
+#include <Ecore.h>
 #include <flutter/method_channel.h>
 #include <flutter/plugin_registrar.h>
 #include <flutter/standard_message_codec.h>
@@ -22,12 +23,17 @@ class WebContainer;
 class TextInputChannel;
 class BufferPool;
 class BufferUnit;
+class FrameTimings;
+class JavaScriptMessageBatcher;
+class WebContainerBinding;
+struct WebContainerEntry;
 
 class WebView : public PlatformView {
  public:
   WebView(flutter::PluginRegistrar* registrar, int viewId,
           flutter::TextureRegistrar* textureRegistrar, double width,
-          double height, flutter::EncodableMap& params, void* platform_window);
+          double height, flutter::EncodableMap& params, void* platform_window,
+          std::unique_ptr<WebContainerEntry> prewarmed_container = nullptr);
   ~WebView();
   virtual void Dispose() override;
   virtual void Resize(double width, double height) override;
@@ -52,6 +58,10 @@ class WebView : public PlatformView {
   FlutterDesktopGpuBuffer* ObtainGpuBuffer(size_t width, size_t height);
   void DestructBuffer(void* buffer);
 
+  // Render callbacks of the LWE container, forwarded by WebContainerBinding.
+  void* PrepareImage();
+  void OnFlush(bool is_rendered);
+
  private:
   void HandleMethodCall(
       const flutter::MethodCall<flutter::EncodableValue>& method_call,
@@ -60,7 +70,10 @@ class WebView : public PlatformView {
       const flutter::MethodCall<flutter::EncodableValue>& method_call,
       std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
   std::string GetChannelName();
-  void InitWebView();
+  void InitWebView(std::unique_ptr<WebContainerEntry> prewarmed_container);
+
+  void DispatchMouseMoveEvent(double x, double y);
+  void FlushPendingMouseMoveEvent();
 
   void RegisterJavaScriptChannelName(const std::string& name);
   void ApplySettings(flutter::EncodableMap);
@@ -73,13 +86,22 @@ class WebView : public PlatformView {
   BufferUnit* candidate_surface_;
   BufferUnit* rendered_surface_;
   bool is_mouse_lbutton_down_;
+  bool has_pending_mouse_move_;
+  double pending_mouse_move_x_;
+  double pending_mouse_move_y_;
+  Ecore_Animator* mouse_move_animator_;
   bool has_navigation_delegate_;
   bool has_progress_tracking_;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>>
+      javascript_batch_channel_;
+  std::unique_ptr<JavaScriptMessageBatcher> javascript_message_batcher_;
   Ecore_IMF_Context* context_;
   flutter::TextureVariant* texture_variant_;
   std::mutex mutex_;
   std::unique_ptr<BufferPool> tbm_pool_;
+  std::shared_ptr<WebContainerBinding> container_binding_;
+  std::unique_ptr<FrameTimings> frame_timings_;
   void* platform_window_;
 };
 
@@ -25,7 +25,8 @@ WebViewFactory::WebViewFactory(flutter::PluginRegistrar* registrar,
                                void* platform_window)
     : PlatformViewFactory(registrar),
       texture_registrar_(texture_registrar),
-      platform_window_(platform_window) {
+      platform_window_(platform_window),
+      container_pool_(std::make_unique<WebContainerPool>()) {
   char* path = app_get_data_path();
   std::string path_string;
   if (!path || strlen(path) == 0) {
@@ -56,11 +57,19 @@ PlatformView* WebViewFactory::Create(
 
   try {
     return new WebView(GetPluginRegistrar(), view_id, texture_registrar_, width,
-                       height, params, platform_window_);
+                       height, params, platform_window_,
+                       container_pool_->Take());
   } catch (const std::invalid_argument& ex) {
     LOG_ERROR("[Exception] %s\n", ex.what());
     return nullptr;
   }
 }
 
-void WebViewFactory::Dispose() { LWE::LWE::Finalize(); }
+void WebViewFactory::Prewarm(int count, double width, double height) {
+  container_pool_->Prewarm(count, width, height);
+}
+
+void WebViewFactory::Dispose() {
+  container_pool_->Clear();
+  LWE::LWE::Finalize();
+}
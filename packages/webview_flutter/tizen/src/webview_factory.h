@@ -5,7 +5,11 @@
 #ifndef FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEVIEW_FACTORY_H_
 #define FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEVIEW_FACTORY_H_
 
+#include <memory>
+
+#include "web_container_pool.h"
 #include "webview.h"
+
 class WebViewFactory : public PlatformViewFactory {
  public:
   WebViewFactory(flutter::PluginRegistrar* registrar,
@@ -16,9 +20,14 @@ class WebViewFactory : public PlatformViewFactory {
       int viewId, double width, double height,
       const std::vector<uint8_t>& createParams) override;
 
+  // Creates |count| web containers in the background so that later Create
+  // calls can hand out a ready container.
+  void Prewarm(int count, double width, double height);
+
  private:
   flutter::TextureRegistrar* texture_registrar_;
   void* platform_window_;
+  std::unique_ptr<WebContainerPool> container_pool_;
 };
 
 #endif  // FLUTTER_PLUGIN_WEBVIEW_FLUTTER_TIZEN_WEVIEW_FACTORY_H_
@@ -4,21 +4,111 @@
 
 #include "webview_flutter_tizen_plugin.h"
 
+#include <flutter/method_channel.h>
+#include <flutter/plugin_registrar.h>
+#include <flutter/standard_method_codec.h>
+
 #include <memory>
 
 #include "flutter_tizen.h"
+#include "surface_pool.h"
 #include "webview_factory.h"
 
 static constexpr char kViewType[] = "plugins.flutter.io/webview";
+static constexpr char kChannelName[] = "plugins.flutter.io/webview_tizen";
 
 class WebviewFlutterTizenPlugin : public flutter::Plugin {
  public:
-  static void RegisterWithRegistrar(flutter::PluginRegistrar* registrar) {
-    auto plugin = std::make_unique<WebviewFlutterTizenPlugin>();
+  static void RegisterWithRegistrar(flutter::PluginRegistrar* registrar,
+                                    WebViewFactory* factory) {
+    auto channel =
+        std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+            registrar->messenger(), kChannelName,
+            &flutter::StandardMethodCodec::GetInstance());
+    auto plugin = std::make_unique<WebviewFlutterTizenPlugin>(factory);
+    channel->SetMethodCallHandler(
+        [plugin_pointer = plugin.get()](const auto& call, auto result) {
+          plugin_pointer->HandleMethodCall(call, std::move(result));
+        });
+    plugin->channel_ = std::move(channel);
     registrar->AddPlugin(std::move(plugin));
   }
-  WebviewFlutterTizenPlugin() {}
+  explicit WebviewFlutterTizenPlugin(WebViewFactory* factory)
+      : factory_(factory) {}
   virtual ~WebviewFlutterTizenPlugin() {}
+
+ private:
+  void HandleMethodCall(
+      const flutter::MethodCall<flutter::EncodableValue>& method_call,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+    const auto& method_name = method_call.method_name();
+    if (method_name == "prewarm") {
+      const auto* arguments =
+          std::get_if<flutter::EncodableMap>(method_call.arguments());
+      if (!arguments) {
+        result->Error("InvalidArguments", "Please set arguments properly");
+        return;
+      }
+      int count = 1;
+      double width = 0, height = 0;
+      auto iter = arguments->find(flutter::EncodableValue("count"));
+      if (iter != arguments->end() &&
+          std::holds_alternative<int>(iter->second)) {
+        count = std::get<int>(iter->second);
+      }
+      iter = arguments->find(flutter::EncodableValue("width"));
+      if (iter != arguments->end() &&
+          std::holds_alternative<double>(iter->second)) {
+        width = std::get<double>(iter->second);
+      }
+      iter = arguments->find(flutter::EncodableValue("height"));
+      if (iter != arguments->end() &&
+          std::holds_alternative<double>(iter->second)) {
+        height = std::get<double>(iter->second);
+      }
+      if (count < 0 || width <= 0 || height <= 0) {
+        result->Error("InvalidArguments",
+                      "Please set 'count', 'width' and 'height' properly");
+        return;
+      }
+      factory_->Prewarm(count, width, height);
+      result->Success();
+    } else if (method_name == "setMaxSurfaces") {
+      const auto* arguments =
+          std::get_if<flutter::EncodableMap>(method_call.arguments());
+      int max_surfaces = 0;
+      if (arguments) {
+        auto iter = arguments->find(flutter::EncodableValue("maxSurfaces"));
+        if (iter != arguments->end() &&
+            std::holds_alternative<int>(iter->second)) {
+          max_surfaces = std::get<int>(iter->second);
+        }
+      }
+      if (max_surfaces <= 0) {
+        result->Error("InvalidArguments",
+                      "Please set 'maxSurfaces' to a positive number");
+        return;
+      }
+      SurfacePool::GetInstance().SetMaxSurfaces(max_surfaces);
+      result->Success();
+    } else if (method_name == "getSurfacePoolStats") {
+      SurfacePool& pool = SurfacePool::GetInstance();
+      flutter::EncodableMap stats = {
+          {flutter::EncodableValue("maxSurfaces"),
+           flutter::EncodableValue(static_cast<int>(pool.MaxSurfaces()))},
+          {flutter::EncodableValue("liveSurfaces"),
+           flutter::EncodableValue(static_cast<int>(pool.LiveCount()))},
+          {flutter::EncodableValue("idleSurfaces"),
+           flutter::EncodableValue(static_cast<int>(pool.IdleCount()))},
+      };
+      result->Success(flutter::EncodableValue(stats));
+    } else {
+      result->NotImplemented();
+    }
+  }
+
+  WebViewFactory* factory_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> channel_;
 };
 
 void WebviewFlutterTizenPluginRegisterWithRegistrar(
@@ -29,6 +119,8 @@ void WebviewFlutterTizenPluginRegisterWithRegistrar(
   auto factory = std::make_unique<WebViewFactory>(
       core_registrar, core_registrar->texture_registrar(),
       FlutterDesktopGetWindow(registrar));
+  WebViewFactory* factory_pointer = factory.get();
   FlutterDesktopRegisterViewFactory(registrar, kViewType, std::move(factory));
-  WebviewFlutterTizenPlugin::RegisterWithRegistrar(core_registrar);
+  WebviewFlutterTizenPlugin::RegisterWithRegistrar(core_registrar,
+                                                   factory_pointer);
 }